@@ -0,0 +1,54 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include <Arduino_MAX17332.h>
+#include <Wire.h>
+
+MAX17332 BMS(Wire);
+
+// 500 ms during transients, up to 1 minute while the pack is idle
+MAX17332_AdaptivePoller poller(BMS, 500, 60000);
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial);
+    if (!BMS.begin()) {
+        Serial.println("Failed to initialize BMS");
+        while(1);
+    }
+    poller.setCurrentThreshold(20000);     // 20 mA
+    poller.begin();
+}
+
+void loop() {
+    int ret = poller.service();
+
+    if (ret == 0) {
+        Serial.println("Failed to read values");
+    } else if (ret == 1) {
+        Serial.print("VCELL: ");
+        Serial.print(poller.vcell(), 4);
+        Serial.print(" CURRENT uA: ");
+        Serial.print(poller.currentMicroAmps());
+        Serial.print(" SOC: ");
+        Serial.print(poller.soc(), 2);
+        Serial.print(poller.charging() ? " CHARGING" : " DISCHARGING");
+        Serial.print(" NEXT IN ms: ");
+        Serial.println(poller.interval());
+
+        MAX17332_AdaptiveReport report = poller.report();
+        Serial.print("BUS TIME us spent: ");
+        Serial.print(report.bus_us);
+        Serial.print(" saved: ");
+        Serial.println(report.saved_us);
+    }
+}
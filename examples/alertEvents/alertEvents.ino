@@ -0,0 +1,53 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include <Arduino_MAX17332.h>
+#include <Wire.h>
+
+// ALRT is open drain, active low. Alerts must be enabled in the gauge configuration (Config.Aen)
+#define ALRT_PIN 2
+
+MAX17332 BMS(Wire);
+MAX17332_Alerts alerts(BMS);
+
+void onAlert() {
+    alerts.notify();
+}
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial);
+    if (!BMS.begin()) {
+        Serial.println("Failed to initialize BMS");
+        while(1);
+    }
+    alerts.begin();
+    pinMode(ALRT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(ALRT_PIN), onAlert, FALLING);
+}
+
+void loop() {
+    // No bus traffic unless ALRT fired
+    if (alerts.service() < 0) {
+        Serial.println("Failed to read alerts");
+    }
+
+    MAX17332_Event event;
+    while (alerts.read(event)) {
+        Serial.print(event.timestamp);
+        Serial.print(event.source == MAX17332_EVENT_STATUS ? " STATUS bit " :
+                     event.source == MAX17332_EVENT_PROT_ALRT ? " PROT_ALRT bit " : " FPROTSTAT bit ");
+        Serial.println(event.bit);
+    }
+
+    delay(10);
+}
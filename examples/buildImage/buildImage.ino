@@ -0,0 +1,60 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include <Arduino_MAX17332.h>
+#include <Wire.h>
+
+MAX17332 BMS(Wire);
+
+// Shadow RAM words set at compile time: no byte offsets, checked by static_asserts.
+// Only these words are written, the rest of the pack configuration is kept
+typedef MAX17332_NvmImage<
+    MAX17332_Nvm::nRSense<10000>,           // 10 mOhm
+    MAX17332_Nvm::UserMem1C6<0xAFBF>,
+    MAX17332_Word<0x1B0, 0x0210>            // any other shadow RAM register by address
+> Config;
+
+uint8_t current[NVM_SIZE];
+uint8_t image[NVM_SIZE];
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial);
+    if (!BMS.begin()) {
+        Serial.println("Failed to initialize BMS");
+        while(1);
+    }
+
+    // Apply the listed words to the pack's own shadow RAM, then write only the words that differ
+    if (BMS.shadowMemDump(current) != 1) {
+        Serial.println("Failed to read the shadow RAM");
+        while(1);
+    }
+    memcpy(image, current, NVM_SIZE);
+    Config::apply(image);
+
+    MAX17332_ShadowDiff diff;
+    if (BMS.writeShadowMemDiff(image, current, &diff) != 1) {
+        Serial.println("Failed to write the shadow RAM");
+    }
+
+    Serial.print("BYTES WRITTEN: ");
+    Serial.print(diff.bytes_written);
+    Serial.println(diff.reset ? " (firmware reset)" : "");
+    Serial.print("IMAGE FINGERPRINT: ");
+    Serial.println(MAX17332_fingerprintOf(image), HEX);
+    Serial.print("RSENSE VALUE: ");
+    Serial.println(BMS.readRSense());
+}
+
+void loop() {
+}
@@ -25,26 +25,12 @@ void setup() {
     }
 }
 
+// Writes the shadow RAM as a 235-byte binary frame (about 0.25 s at 9600 baud).
+// Decode on the host with: extras/tools/max17332_frames.py --port <serial port> --count 1
 void loop() {
-    uint8_t data[NVM_SIZE];
-
-    BMS.shadowMemDump(data);
-
-    Serial.println("[");
-
-    for (int page = 0; page < 7; page++) {
-        for (int j = 0; j < 32; j++) {
-            Serial.print("0x");
-            if (data[page*32 + j] < 16) {
-                Serial.print("0");
-            }
-            Serial.print(data[page*32 + j], HEX);
-            Serial.print(", ");
-        }
-        Serial.println("");
+    if (BMS.shadowMemDump(Serial) != 1) {
+        Serial.println("Failed to dump shadow RAM");
     }
 
-    Serial.println("]");
     delay(10000);
-
-}
\ No newline at end of file
+}
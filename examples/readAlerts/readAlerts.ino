@@ -22,9 +22,13 @@ void setup() {
         Serial.println("Failed to initialize BMS");
         while(1);
     }
+    // Predicates below share one status read per loop
+    BMS.setStatusMaxAge(100);
 }
 
 void loop() {
+    BMS.refreshStatus();
+
     BMS.hasAlerts() ? Serial.println("BMS HAS ALERTS") : Serial.println("BMS HAS NO ALERTS");
     BMS.isProtectionAlert() ? Serial.println("BMS PROTECTION ALERT") : Serial.println("PA OK");
     BMS.isChargingAlert() ? Serial.println("BMS CHARGING ALERT") : Serial.println("CA OK");
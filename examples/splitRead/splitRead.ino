@@ -0,0 +1,77 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include <Arduino_MAX17332.h>
+#include <Wire.h>
+
+#define READ_INTERVAL 500
+
+MAX17332 BMS(Wire);
+
+static const uint16_t registers[] = {
+    MAX17332_VCELL_REG,
+    MAX17332_CURR_REG,
+    MAX17332_TEMP_REG,
+    MAX17332_REPSOC_REG,
+};
+
+MAX17332_ReadPlan plan(registers, sizeof(registers) / sizeof(registers[0]));
+uint16_t buffer[MAX17332_PLAN_MAX_BURST_WORDS];   // at least plan.words()
+unsigned long last_read = 0;
+bool reading = false;
+
+void serviceRadio() {
+    // Time critical work sharing the loop with the gauge
+}
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial);
+    if (!BMS.begin()) {
+        Serial.println("Failed to initialize BMS");
+        while(1);
+    }
+}
+
+void loop() {
+    serviceRadio();
+
+    if (!reading && millis() - last_read >= READ_INTERVAL) {
+        reading = (BMS.startRead(plan, buffer) == 1);
+        last_read = millis();
+    }
+
+    if (!reading) {
+        return;
+    }
+
+    // Each call issues at most one burst, the loop keeps running in between
+    int ret = BMS.pollRead();
+    if (ret == MAX17332_PENDING) {
+        return;
+    }
+
+    reading = false;
+    if (ret != 1) {
+        Serial.println("Failed to read values");
+        return;
+    }
+
+    Serial.print("VCELL: ");
+    Serial.print(plan.get<MAX17332_Reg::VCell>(buffer));
+    Serial.print(" CURRENT: ");
+    Serial.print(BMS.currentAmps(plan.value(buffer, MAX17332_CURR_REG)), 6);
+    Serial.print(" TEMP: ");
+    Serial.print(plan.get<MAX17332_Reg::Temp>(buffer));
+    Serial.print(" SOC: ");
+    Serial.println(plan.get<MAX17332_Reg::RepSoc>(buffer));
+}
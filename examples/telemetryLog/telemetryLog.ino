@@ -0,0 +1,63 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include <Arduino_MAX17332.h>
+#include <Wire.h>
+
+MAX17332 BMS(Wire);
+
+// About 5.5 bytes per record with keyframes: 4 KiB keep some 750 records, 75 s at 10 Hz.
+// Boards with 2 KB of RAM (AVR) get 512 bytes, some 9 s
+#if defined(__AVR__)
+uint8_t storage[512];
+#else
+uint8_t storage[4096];
+#endif
+MAX17332_Telemetry telemetry(BMS, storage, sizeof(storage));
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial);
+    if (!BMS.begin()) {
+        Serial.println("Failed to initialize BMS");
+        while(1);
+    }
+}
+
+void loop() {
+    static unsigned long last_dump = millis();
+
+    telemetry.record();
+
+    if (millis() - last_dump > 60000) {
+        MAX17332_TelemetryReader reader(telemetry);
+        MAX17332_Sample sample;
+
+        while (reader.read(sample)) {
+            Serial.print(sample.timestamp);
+            Serial.print(",");
+            Serial.print(MAX17332_Reg::VCellRep::decodeInt(sample.vcell));
+            Serial.print(",");
+            Serial.print(MAX17332_Reg::Temp::decodeInt(sample.temp));
+            Serial.print(",");
+            Serial.println(MAX17332_Reg::RepSoc::decodeInt(sample.soc));
+        }
+        Serial.print(telemetry.records());
+        Serial.print(" records in ");
+        Serial.print(telemetry.used());
+        Serial.println(" bytes");
+
+        last_dump = millis();
+    }
+
+    delay(100);
+}
@@ -0,0 +1,69 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "Arduino.h"
+
+#include <time.h>
+
+static bool virtual_clock = false;
+static uint64_t virtual_us = 0;
+
+static uint64_t real_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t start_us = real_us();
+
+static uint64_t now_us() {
+    return virtual_clock ? virtual_us : real_us() - start_us;
+}
+
+unsigned long millis() {
+    return (unsigned long) (now_us() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long) now_us();
+}
+
+void delay(unsigned long ms) {
+    if (virtual_clock) {
+        virtual_us += (uint64_t) ms * 1000;
+        return;
+    }
+
+    struct timespec ts = { (time_t) (ms / 1000), (long) (ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (virtual_clock) {
+        virtual_us += us;
+        return;
+    }
+
+    struct timespec ts = { (time_t) (us / 1000000), (long) (us % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+void hostClockSetVirtual(bool enable) {
+    virtual_us = now_us();
+    virtual_clock = enable;
+}
+
+void hostClockAdvance(uint32_t us) {
+    if (virtual_clock) {
+        virtual_us += us;
+    }
+}
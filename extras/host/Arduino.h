@@ -0,0 +1,108 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Minimal Arduino core surface for building the library on a Linux host
+*/
+
+#ifndef  _MAX17332_HOST_ARDUINO_H_
+#define  _MAX17332_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEX 16
+#define DEC 10
+#define BIN 2
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+/**
+ * Byte sink, as the Arduino core Print
+*/
+class Print {
+
+    public:
+        virtual ~Print() {}
+
+        virtual size_t write(uint8_t data) = 0;
+
+        virtual size_t write(const uint8_t* data, size_t length) {
+            size_t i = 0;
+
+            while (i < length && write(data[i])) {
+                i++;
+            }
+
+            return i;
+        }
+
+        size_t print(const char* text) {
+            return write((const uint8_t*) text, strlen(text));
+        }
+
+        size_t print(unsigned long value, int base = DEC) {
+            char text[33];
+            char* p = &text[sizeof(text) - 1];
+
+            *p = '\0';
+            do {
+                *--p = "0123456789ABCDEF"[value % base];
+                value /= base;
+            } while (value);
+
+            return print(p);
+        }
+
+        size_t print(long value, int base = DEC) {
+            if (value < 0 && base == DEC) {
+                return print("-") + print((unsigned long) -value, base);
+            }
+
+            return print((unsigned long) value, base);
+        }
+
+        size_t println() {
+            return print("\r\n");
+        }
+
+        template <typename T>
+        size_t println(T value) {
+            return print(value) + println();
+        }
+
+        template <typename T>
+        size_t println(T value, int base) {
+            return print(value, base) + println();
+        }
+
+};
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/**
+    @brief  Switches millis()/micros()/delay() to a virtual clock. delay() then returns immediately
+*/
+void hostClockSetVirtual(bool enable);
+
+/**
+    @brief  Advances the virtual clock (no effect on the real clock)
+*/
+void hostClockAdvance(uint32_t us);
+
+#endif
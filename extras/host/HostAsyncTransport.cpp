@@ -0,0 +1,89 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Transport.h"
+#include "HostAsyncTransport.h"
+
+uint8_t HostAsyncTransport::polls = HOST_ASYNC_POLLS;
+HostAsyncStats HostAsyncTransport::stats;
+
+HostAsyncTransport::HostAsyncTransport(TwoWire& wire): _wire(&wire), _address(0), _reg(0), _data(NULL), _length(0),
+    _left(0), _read_result(0) {}
+
+void HostAsyncTransport::begin() {
+    _wire->begin();
+}
+
+void HostAsyncTransport::end() {
+    _wire->end();
+}
+
+int HostAsyncTransport::read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    _wire->beginTransmission(i2c_address);
+    _wire->write(reg);
+
+    if (_wire->endTransmission(false) != 0) {
+        return -1;
+    }
+
+    if (_wire->requestFrom(i2c_address, length) != length) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        *data++ = _wire->read();
+    }
+
+    return 1;
+}
+
+int HostAsyncTransport::write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length) {
+    _wire->beginTransmission(i2c_address);
+    _wire->write(reg);
+
+    for (size_t i = 0; i < length; i++) {
+        _wire->write(data[i]);
+    }
+
+    return _wire->endTransmission() == 0 ? 1 : 0;
+}
+
+void HostAsyncTransport::beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    _address = i2c_address;
+    _reg = reg;
+    _data = data;
+    _length = length;
+    _left = polls + 1;
+
+    // A caller reading the buffer before completion sees garbage, not stale values
+    memset(data, HOST_ASYNC_FILL, length);
+    stats.reads++;
+}
+
+int HostAsyncTransport::pollRead() {
+    if (_left == 0) {
+        return _read_result;
+    }
+
+    if (--_left > 0) {
+        stats.pending++;
+        return MAX17332_TRANSPORT_PENDING;
+    }
+
+    _read_result = read(_address, _reg, _data, _length);
+
+    return _read_result;
+}
+
+TwoWire* HostAsyncTransport::bus() {
+    return _wire;
+}
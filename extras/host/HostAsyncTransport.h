@@ -0,0 +1,76 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Fake asynchronous transport for the MAX17332_TRANSPORT_CLASS hook (see MAX17332_Transport.h):
+ * a split-phase read stays in flight for HostAsyncTransport::polls calls of pollRead(), like a
+ * DMA transfer, and only then runs on the TwoWire shim
+*/
+
+#ifndef  _MAX17332_HOST_ASYNC_TRANSPORT_H_
+#define  _MAX17332_HOST_ASYNC_TRANSPORT_H_
+
+#include <Wire.h>
+
+#define HOST_ASYNC_POLLS        3           ///< default pollRead() calls returning PENDING per read
+#define HOST_ASYNC_FILL         0xA5        ///< buffer contents while a read is in flight
+
+/**
+ * Struct for counting split-phase reads
+*/
+typedef struct
+{
+    uint32_t reads;         ///< beginRead() calls
+    uint32_t pending;       ///< pollRead() calls that returned MAX17332_TRANSPORT_PENDING
+
+} HostAsyncStats;
+
+class HostAsyncTransport {
+
+    public:
+        typedef TwoWire Bus;
+
+        HostAsyncTransport(TwoWire& wire);
+
+        void begin();
+        void end();
+
+        int read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+        int write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length);
+
+        /**
+            @brief  Queues a read and fills data with HOST_ASYNC_FILL until it completes
+        */
+        void beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+
+        /**
+            @brief  Returns MAX17332_TRANSPORT_PENDING for HostAsyncTransport::polls calls, then
+                    runs the read on the bus and returns its result
+        */
+        int pollRead();
+
+        TwoWire* bus();
+
+        static uint8_t polls;               ///< pollRead() calls returning PENDING per read
+        static HostAsyncStats stats;        ///< shared by all instances
+
+    private:
+        TwoWire* _wire;
+        uint8_t _address;
+        uint8_t _reg;
+        uint8_t* _data;
+        size_t _length;
+        uint8_t _left;                      ///< PENDING answers left, 0 once the read completed
+        int _read_result;
+};
+
+#endif
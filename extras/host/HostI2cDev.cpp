@@ -0,0 +1,110 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "HostI2cDev.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+HostI2cDevAdapter I2cDev;
+
+HostI2cDevAdapter::HostI2cDevAdapter(): _num_devices(0), _frequency(100000) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void HostI2cDevAdapter::setClock(uint32_t frequency) {
+    _frequency = frequency;
+}
+
+int HostI2cDevAdapter::attach(HostI2CDevice& device) {
+    if (_num_devices >= HOST_WIRE_MAX_DEVICES) {
+        return 0;
+    }
+
+    _devices[_num_devices++] = &device;
+
+    return 1;
+}
+
+void HostI2cDevAdapter::detachAll() {
+    _num_devices = 0;
+}
+
+int HostI2cDevAdapter::ioctl(unsigned long request, void* arg) {
+    if (request != I2C_RDWR) {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    struct i2c_rdwr_ioctl_data* rdwr = (struct i2c_rdwr_ioctl_data*) arg;
+    size_t bytes = 0;
+    int ret = 0;
+
+    stats.ioctls++;
+
+    for (uint32_t i = 0; i < rdwr->nmsgs && ret == 0; i++) {
+        struct i2c_msg* message = &rdwr->msgs[i];
+        HostI2CDevice* device = find(message->addr);
+
+        stats.messages++;
+        bytes += 1;
+
+        if (!device) {
+            errno = ENXIO;
+            ret = -1;
+        } else if (message->flags & I2C_M_RD) {
+            size_t length = device->read(message->addr, message->buf, message->len);
+            bytes += length;
+            if (length != message->len) {
+                errno = EIO;
+                ret = -1;
+            }
+        } else {
+            bytes += message->len;
+            if (device->write(message->addr, message->buf, message->len) != 0) {
+                errno = EIO;
+                ret = -1;
+            }
+        }
+    }
+
+    if (ret != 0) {
+        stats.errors++;
+    }
+
+    stats.bytes += bytes;
+
+    // Same bus time model as TwoWire: 9 clocks per byte plus START/STOP
+    hostClockAdvance((uint32_t) (((uint64_t) bytes * 9 + 2) * 1000000 / _frequency));
+
+    return ret;
+}
+
+HostI2CDevice* HostI2cDevAdapter::find(uint8_t address) {
+    for (size_t i = 0; i < _num_devices; i++) {
+        if (_devices[i]->acknowledge(address)) {
+            return _devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+int hostI2cDevIoctl(int fd, unsigned long request, void* arg) {
+    (void) fd;
+    return I2cDev.ioctl(request, arg);
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Fake Linux i2c-dev adapter: an ioctl() replacement routing I2C_RDWR transfers to in-process simulated i2c devices
+*/
+
+#ifndef  _MAX17332_HOST_I2CDEV_H_
+#define  _MAX17332_HOST_I2CDEV_H_
+
+#include "Wire.h"
+
+#if defined(__linux__)
+
+/**
+ * Struct for counting fake adapter traffic
+*/
+typedef struct
+{
+    uint32_t ioctls;        ///< I2C_RDWR calls (one kernel round trip each)
+    uint32_t messages;      ///< i2c_msg segments
+    uint32_t bytes;         ///< bytes on the wire, address bytes included
+    uint32_t errors;
+
+} HostI2cDevStats;
+
+class HostI2cDevAdapter {
+
+    public:
+        HostI2cDevAdapter();
+
+        void setClock(uint32_t frequency);
+
+        /**
+            @brief  Attaches a simulated device to the adapter
+            @return 1 if OK; 0 if the adapter is full
+        */
+        int attach(HostI2CDevice& device);
+
+        void detachAll();
+
+        /**
+            @brief  Handles an ioctl on the adapter. Only I2C_RDWR is supported
+            @return 0 if OK; -1 on NACK, short read or unsupported request
+        */
+        int ioctl(unsigned long request, void* arg);
+
+        HostI2cDevStats stats;
+
+    private:
+        HostI2CDevice* find(uint8_t address);
+
+        HostI2CDevice* _devices[HOST_WIRE_MAX_DEVICES];
+        size_t _num_devices;
+        uint32_t _frequency;
+
+};
+
+extern HostI2cDevAdapter I2cDev;
+
+/**
+ * MAX17332_IoctlFn routing to I2cDev
+*/
+int hostI2cDevIoctl(int fd, unsigned long request, void* arg);
+
+#endif
+
+#endif
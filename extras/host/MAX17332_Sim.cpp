@@ -0,0 +1,237 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Sim.h"
+
+#define NVM_WORDS           (NVM_SIZE / 2)
+#define CONFIG2_POR_CMD     0x8000
+#define STATUS_POR          0x0002
+
+MAX17332_Sim::MAX17332_Sim(uint8_t address_l, uint8_t address_h): _address_l(address_l), _address_h(address_h), _present(true),
+    _t_block(MAX17332_SIM_TBLOCK), _t_recall(MAX17332_SIM_TRECALL), _t_por(MAX17332_SIM_TPOR) {
+
+    // Factory NVM: 10 mOhm sense resistor and a ROMID
+    memset(_nvm, 0, sizeof(_nvm));
+    _nvm[MAX17332_RSENSE_REG - NVM_START_ADDRESS] = 10000;
+    for (uint16_t i = 0; i < 4; i++) {
+        _nvm[MAX17332_SIM_ROMID_REG - NVM_START_ADDRESS + i] = 0x1700 + i;
+    }
+    _nvm_writes = 0;
+    _firmware_resets = 0;
+    _ignored_writes = 0;
+
+    powerOn();
+}
+
+void MAX17332_Sim::powerOn() {
+    memset(_regs, 0, sizeof(_regs));
+    recall();
+
+    _regs[MAX17332_STATUS_REG] = STATUS_POR;
+    _regs[MAX17332_DEVNAME_REG] = MAX17332_DEVICE_NAME;
+    _regs[MAX17332_VCELL_REG] = 48640;                      // 3.8 V
+    _regs[MAX17332_VCELLREP_REG] = 48640;
+    _regs[MAX17332_CURR_REG] = (uint16_t) -3200;            // -500 mA on 10 mOhm
+    _regs[MAX17332_CURRREP_REG] = (uint16_t) -3200;
+    _regs[MAX17332_TEMP_REG] = 25 * 256;                    // 25 degC
+    _regs[MAX17332_REPSOC_REG] = 80 * 256;                  // 80 %
+    _regs[MAX17332_AVSOC_REG] = 80 * 256;
+    _regs[MAX17332_FPROTSTAT_REG] = FPROTSTAT_ISDIS_MASK;   // discharging
+
+    _pointer = 0;
+    _locked = true;
+    _last_commstat = -1;
+    _nv_busy = false;
+    _por_busy = false;
+}
+
+void MAX17332_Sim::setPresent(bool present) {
+    _present = present;
+}
+
+void MAX17332_Sim::setTimings(uint32_t t_block, uint32_t t_recall, uint32_t t_por) {
+    _t_block = t_block;
+    _t_recall = t_recall;
+    _t_por = t_por;
+}
+
+uint16_t MAX17332_Sim::getRegister(uint16_t address) {
+    tick();
+    return _regs[address & (MAX17332_SIM_REGISTERS - 1)];
+}
+
+void MAX17332_Sim::setRegister(uint16_t address, uint16_t value) {
+    _regs[address & (MAX17332_SIM_REGISTERS - 1)] = value;
+}
+
+bool MAX17332_Sim::isLocked() {
+    return _locked;
+}
+
+uint8_t MAX17332_Sim::nvmWrites() {
+    return _nvm_writes;
+}
+
+void MAX17332_Sim::setNvmWrites(uint8_t writes) {
+    _nvm_writes = writes;
+}
+
+uint32_t MAX17332_Sim::firmwareResets() {
+    return _firmware_resets;
+}
+
+uint32_t MAX17332_Sim::ignoredWrites() {
+    return _ignored_writes;
+}
+
+bool MAX17332_Sim::acknowledge(uint8_t address) {
+    return _present && (address == _address_l || address == _address_h);
+}
+
+uint8_t MAX17332_Sim::write(uint8_t address, const uint8_t* data, size_t length) {
+    tick();
+
+    if (length == 0) {
+        return 0;
+    }
+
+    _pointer = (address == _address_h ? 0x100 : 0x000) | data[0];
+
+    // Data is written word by word, LSB first. A trailing odd byte is discarded
+    for (size_t i = 1; i + 1 < length; i += 2) {
+        writeWord(_pointer, data[i] | (data[i + 1] << 8));
+        _pointer = (_pointer + 1) & (MAX17332_SIM_REGISTERS - 1);
+    }
+
+    return 0;
+}
+
+size_t MAX17332_Sim::read(uint8_t address, uint8_t* data, size_t length) {
+    (void) address;
+    tick();
+
+    uint16_t pointer = _pointer;
+
+    for (size_t i = 0; i < length; i++) {
+        uint16_t value = _regs[pointer];
+        data[i] = (i & 1) ? (value >> 8) : (value & 0xFF);
+        if (i & 1) {
+            pointer = (pointer + 1) & (MAX17332_SIM_REGISTERS - 1);
+        }
+    }
+
+    return length;
+}
+
+void MAX17332_Sim::tick() {
+    uint32_t now = millis();
+
+    if (_nv_busy && now - _nv_busy_start >= _nv_busy_time) {
+        _nv_busy = false;
+        _regs[MAX17332_COMMSTAT_REG] &= ~COMMSTAT_NVBUSY_MASK;
+    }
+
+    if (_por_busy && now - _por_start >= _t_por) {
+        _por_busy = false;
+        _regs[MAX17332_CONFIG2_REG] &= ~CONFIG2_POR_CMD;
+    }
+}
+
+void MAX17332_Sim::writeWord(uint16_t address, uint16_t value) {
+
+    if (address == MAX17332_COMMSTAT_REG) {
+        // Protection changes only when the same value is written twice in a row
+        if (value == 0x0000) {
+            _regs[MAX17332_COMMSTAT_REG] &= ~COMMSTAT_NVERROR_MASK;
+            if (_last_commstat == 0x0000) {
+                _locked = false;
+            }
+        } else if (value == MAX17332_SIM_COMMSTAT_LOCK && _last_commstat == MAX17332_SIM_COMMSTAT_LOCK) {
+            _locked = true;
+        }
+        _last_commstat = value;
+        return;
+    }
+
+    _last_commstat = -1;
+
+    if (address == MAX17332_COMMAND_REG) {
+        command(value);
+        return;
+    }
+
+    if (_locked || (address >= MAX17332_SIM_ROMID_REG && address < MAX17332_SIM_ROMID_REG + 4)) {
+        _ignored_writes++;
+        return;
+    }
+
+    if (address == MAX17332_CONFIG2_REG && (value & CONFIG2_POR_CMD)) {
+        _por_busy = true;
+        _por_start = millis();
+        _firmware_resets++;
+    }
+
+    _regs[address] = value;
+}
+
+void MAX17332_Sim::command(uint16_t cmd) {
+
+    if (_nv_busy) {
+        _ignored_writes++;
+        return;
+    }
+
+    switch (cmd) {
+        case COPY_NV_BLOCK_CMD:
+            if (_locked || _nvm_writes >= MAX17332_SIM_NVM_WRITES) {
+                _regs[MAX17332_COMMSTAT_REG] |= COMMSTAT_NVERROR_MASK;
+                return;
+            }
+            for (uint16_t i = 0; i < NVM_WORDS; i++) {
+                uint16_t address = NVM_START_ADDRESS + i;
+                if (address < MAX17332_SIM_ROMID_REG || address >= MAX17332_SIM_ROMID_REG + 4) {
+                    _nvm[i] = _regs[address];
+                }
+            }
+            _nvm_writes++;
+            _nv_busy_time = _t_block;
+            break;
+
+        case NV_RECALL_CMD:
+            recall();
+            _nv_busy_time = _t_recall;
+            break;
+
+        case NV_REMAINING_UPDATES_CMD:
+            // One bit per used update, mirrored in both bytes
+            _regs[MAX17332_NV_UPDATES_REG] = ((1 << _nvm_writes) - 1) * 0x0101;
+            _nv_busy_time = _t_recall;
+            break;
+
+        case HARDWARE_RESET_CMD:
+            powerOn();
+            return;
+
+        default:
+            return;
+    }
+
+    _nv_busy = true;
+    _nv_busy_start = millis();
+    _regs[MAX17332_COMMSTAT_REG] |= COMMSTAT_NVBUSY_MASK;
+}
+
+void MAX17332_Sim::recall() {
+    for (uint16_t i = 0; i < NVM_WORDS; i++) {
+        _regs[NVM_START_ADDRESS + i] = _nvm[i];
+    }
+}
@@ -0,0 +1,120 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_SIM_H_
+#define  _MAX17332_SIM_H_
+
+#include <Wire.h>
+#include "MAX17332.h"
+
+// SIMULATION DEFAULTS
+#define MAX17332_SIM_REGISTERS      0x200           ///< 9-bit register map
+#define MAX17332_SIM_TBLOCK         7360            ///< ms, COPY_NV_BLOCK_CMD busy time
+#define MAX17332_SIM_TRECALL        5               ///< ms, NV_RECALL_CMD busy time
+#define MAX17332_SIM_TPOR           10              ///< ms, CONFIG2 POR_CMD firmware reset time
+#define MAX17332_SIM_NVM_WRITES     7               ///< Block copies allowed by the NVM
+#define MAX17332_SIM_ROMID_REG      0x1BC           ///< First of four read-only ROMID words
+#define MAX17332_SIM_COMMSTAT_LOCK  0x00F9          ///< Value that restores write protection
+
+/**
+ * Simulated MAX17332. Answers on both i2c addresses and models the register map, COMMSTAT
+ * write protection, NVM block copy, NV recall, remaining NVM updates, hardware reset and CONFIG2 firmware reset
+*/
+class MAX17332_Sim : public HostI2CDevice {
+
+    public:
+        MAX17332_Sim(uint8_t address_l = MAX17332_ADDRESS_L, uint8_t address_h = MAX17332_ADDRESS_H);
+
+        /**
+            @brief  Restores the power-on register content and NVM
+        */
+        void powerOn();
+
+        /**
+            @brief  Connects or disconnects the device from the bus (NACKs all transactions)
+        */
+        void setPresent(bool present);
+
+        /**
+            @brief  Sets the simulated timings (ms)
+        */
+        void setTimings(uint32_t t_block, uint32_t t_recall, uint32_t t_por);
+
+        /**
+            @brief  Backdoor register access. Bypasses write protection
+        */
+        uint16_t getRegister(uint16_t address);
+        void setRegister(uint16_t address, uint16_t value);
+
+        /**
+            @brief  Returns true if COMMSTAT write protection is active
+        */
+        bool isLocked();
+
+        /**
+            @brief  Returns the number of NVM block copies performed
+        */
+        uint8_t nvmWrites();
+
+        /**
+            @brief  Sets the number of NVM block copies already used
+        */
+        void setNvmWrites(uint8_t writes);
+
+        /**
+            @brief  Returns the number of firmware resets performed
+        */
+        uint32_t firmwareResets();
+
+        /**
+            @brief  Returns the number of writes ignored because of write protection
+        */
+        uint32_t ignoredWrites();
+
+        // HostI2CDevice
+        bool acknowledge(uint8_t address);
+        uint8_t write(uint8_t address, const uint8_t* data, size_t length);
+        size_t read(uint8_t address, uint8_t* data, size_t length);
+
+    private:
+        void tick();
+        void writeWord(uint16_t address, uint16_t value);
+        void command(uint16_t cmd);
+        void recall();
+
+        uint16_t _regs[MAX17332_SIM_REGISTERS];
+        uint16_t _nvm[NVM_SIZE / 2];
+
+        uint8_t _address_l;
+        uint8_t _address_h;
+        bool _present;
+
+        uint16_t _pointer;              ///< Register pointer set by the last write
+        bool _locked;
+        int32_t _last_commstat;         ///< Last COMMSTAT value written, -1 if another write came after it
+
+        uint32_t _t_block;
+        uint32_t _t_recall;
+        uint32_t _t_por;
+        bool _nv_busy;
+        uint32_t _nv_busy_start;
+        uint32_t _nv_busy_time;
+        bool _por_busy;
+        uint32_t _por_start;
+
+        uint8_t _nvm_writes;
+        uint32_t _firmware_resets;
+        uint32_t _ignored_writes;
+
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "TCA9548_Sim.h"
+
+TCA9548_Sim::TCA9548_Sim(uint8_t address): _address(address), _control(0), _selects(0) {
+    memset(_channels, 0, sizeof(_channels));
+}
+
+int TCA9548_Sim::attach(uint8_t channel, HostI2CDevice& device) {
+    if (channel >= TCA9548_SIM_CHANNELS) {
+        return 0;
+    }
+
+    _channels[channel] = &device;
+
+    return 1;
+}
+
+uint8_t TCA9548_Sim::control() {
+    return _control;
+}
+
+uint32_t TCA9548_Sim::selects() {
+    return _selects;
+}
+
+bool TCA9548_Sim::acknowledge(uint8_t address) {
+    return address == _address || find(address) != NULL;
+}
+
+uint8_t TCA9548_Sim::write(uint8_t address, const uint8_t* data, size_t length) {
+    if (address == _address) {
+        if (length > 0) {
+            _control = data[length - 1];
+            _selects++;
+        }
+        return 0;
+    }
+
+    HostI2CDevice* device = find(address);
+
+    return device ? device->write(address, data, length) : 2;
+}
+
+size_t TCA9548_Sim::read(uint8_t address, uint8_t* data, size_t length) {
+    if (address == _address) {
+        memset(data, _control, length);
+        return length;
+    }
+
+    HostI2CDevice* device = find(address);
+
+    return device ? device->read(address, data, length) : 0;
+}
+
+HostI2CDevice* TCA9548_Sim::find(uint8_t address) {
+    // Several enabled channels answering the same address would collide; the first one wins
+    for (uint8_t i = 0; i < TCA9548_SIM_CHANNELS; i++) {
+        if ((_control & (1 << i)) && _channels[i] && _channels[i]->acknowledge(address)) {
+            return _channels[i];
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,61 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _TCA9548_SIM_H_
+#define  _TCA9548_SIM_H_
+
+#include <Wire.h>
+
+#define TCA9548_SIM_ADDRESS     0x70
+#define TCA9548_SIM_CHANNELS    8
+
+/**
+ * Simulated TCA9548 i2c mux. The control byte enables downstream channels; transactions to other
+ * addresses are forwarded to the devices attached to the enabled channels
+*/
+class TCA9548_Sim : public HostI2CDevice {
+
+    public:
+        TCA9548_Sim(uint8_t address = TCA9548_SIM_ADDRESS);
+
+        /**
+            @brief  Attaches a simulated device to a downstream channel (one per channel)
+            @return 1 if OK; 0 on invalid channel
+        */
+        int attach(uint8_t channel, HostI2CDevice& device);
+
+        /**
+            @brief  Returns the control register
+        */
+        uint8_t control();
+
+        /**
+            @brief  Returns the number of control register writes
+        */
+        uint32_t selects();
+
+        // HostI2CDevice
+        bool acknowledge(uint8_t address);
+        uint8_t write(uint8_t address, const uint8_t* data, size_t length);
+        size_t read(uint8_t address, uint8_t* data, size_t length);
+
+    private:
+        HostI2CDevice* find(uint8_t address);
+
+        uint8_t _address;
+        uint8_t _control;
+        uint32_t _selects;
+        HostI2CDevice* _channels[TCA9548_SIM_CHANNELS];
+
+};
+
+#endif
@@ -0,0 +1,141 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire(): _num_devices(0), _frequency(100000), _tx_address(0), _tx_length(0), _rx_length(0), _rx_index(0) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void TwoWire::begin() {}
+
+void TwoWire::end() {}
+
+void TwoWire::setClock(uint32_t frequency) {
+    _frequency = frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _tx_address = address;
+    _tx_length = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_tx_length >= HOST_WIRE_BUFFER_SIZE) {
+        return 0;
+    }
+
+    _tx_buffer[_tx_length++] = data;
+
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t i = 0;
+
+    while (i < length && write(data[i])) {
+        i++;
+    }
+
+    return i;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+    (void) stop;
+    HostI2CDevice* device = find(_tx_address);
+
+    stats.transactions++;
+
+    if (!device) {
+        account(1);
+        stats.nacks++;
+        return 2;
+    }
+
+    account(1 + _tx_length);
+
+    uint8_t ret = device->write(_tx_address, _tx_buffer, _tx_length);
+    if (ret != 0) {
+        stats.nacks++;
+    }
+
+    return ret;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool stop) {
+    (void) stop;
+    HostI2CDevice* device = find(address);
+
+    _rx_length = 0;
+    _rx_index = 0;
+    stats.transactions++;
+
+    if (!device) {
+        account(1);
+        stats.nacks++;
+        return 0;
+    }
+
+    if (quantity > HOST_WIRE_BUFFER_SIZE) {
+        quantity = HOST_WIRE_BUFFER_SIZE;
+    }
+
+    _rx_length = device->read(address, _rx_buffer, quantity);
+    account(1 + _rx_length);
+
+    return _rx_length;
+}
+
+int TwoWire::available() {
+    return _rx_length - _rx_index;
+}
+
+int TwoWire::read() {
+    if (_rx_index >= _rx_length) {
+        return -1;
+    }
+
+    return _rx_buffer[_rx_index++];
+}
+
+int TwoWire::attach(HostI2CDevice& device) {
+    if (_num_devices >= HOST_WIRE_MAX_DEVICES) {
+        return 0;
+    }
+
+    _devices[_num_devices++] = &device;
+
+    return 1;
+}
+
+void TwoWire::detachAll() {
+    _num_devices = 0;
+}
+
+HostI2CDevice* TwoWire::find(uint8_t address) {
+    for (size_t i = 0; i < _num_devices; i++) {
+        if (_devices[i]->acknowledge(address)) {
+            return _devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+void TwoWire::account(size_t bytes) {
+    stats.bytes += bytes;
+
+    // 9 clocks per byte (ACK included) plus START/STOP. Lets blocking waits progress on the virtual clock
+    hostClockAdvance((uint32_t) (((uint64_t) bytes * 9 + 2) * 1000000 / _frequency));
+}
@@ -0,0 +1,114 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Host TwoWire routing transactions to in-process simulated i2c devices
+*/
+
+#ifndef  _MAX17332_HOST_WIRE_H_
+#define  _MAX17332_HOST_WIRE_H_
+
+#include "Arduino.h"
+
+#define HOST_WIRE_MAX_DEVICES   8
+#define HOST_WIRE_BUFFER_SIZE   256
+
+/**
+ * Simulated i2c target
+*/
+class HostI2CDevice {
+
+    public:
+        virtual ~HostI2CDevice() {}
+
+        /**
+            @brief  Returns true if the device ACKs address
+        */
+        virtual bool acknowledge(uint8_t address) = 0;
+
+        /**
+            @brief  Handles a write transaction
+            @return 0 if OK; 3 on data NACK
+        */
+        virtual uint8_t write(uint8_t address, const uint8_t* data, size_t length) = 0;
+
+        /**
+            @brief  Handles a read transaction
+            @return number of bytes provided
+        */
+        virtual size_t read(uint8_t address, uint8_t* data, size_t length) = 0;
+
+};
+
+/**
+ * Struct for counting host bus traffic
+*/
+typedef struct
+{
+    uint32_t transactions;  ///< addressed segments (write or read)
+    uint32_t bytes;         ///< bytes on the wire, address bytes included
+    uint32_t nacks;
+
+} HostWireStats;
+
+class TwoWire {
+
+    public:
+        TwoWire();
+
+        void begin();
+        void end();
+        void setClock(uint32_t frequency);
+
+        void beginTransmission(uint8_t address);
+        size_t write(uint8_t data);
+        size_t write(const uint8_t* data, size_t length);
+        uint8_t endTransmission(bool stop = true);
+
+        size_t requestFrom(uint8_t address, size_t quantity, bool stop = true);
+        int available();
+        int read();
+
+        /**
+            @brief  Attaches a simulated device to the bus
+            @return 1 if OK; 0 if the bus is full
+        */
+        int attach(HostI2CDevice& device);
+
+        /**
+            @brief  Detaches all simulated devices
+        */
+        void detachAll();
+
+        HostWireStats stats;
+
+    private:
+        HostI2CDevice* find(uint8_t address);
+        void account(size_t bytes);
+
+        HostI2CDevice* _devices[HOST_WIRE_MAX_DEVICES];
+        size_t _num_devices;
+        uint32_t _frequency;
+
+        uint8_t _tx_address;
+        uint8_t _tx_buffer[HOST_WIRE_BUFFER_SIZE];
+        size_t _tx_length;
+
+        uint8_t _rx_buffer[HOST_WIRE_BUFFER_SIZE];
+        size_t _rx_length;
+        size_t _rx_index;
+
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,89 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Drives MAX17332_AdaptivePoller through a simulated day: idle, a load transient, idle, a charge
+ * with SOC changes, idle. Prints the polls and interval of each phase and the bus time report.
+ * Exits with 1 if a SOC change was missed
+*/
+
+#include <stdio.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+#define STEP_MS     100
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+MAX17332_AdaptivePoller poller(BMS);
+
+typedef struct
+{
+    const char* name;
+    uint32_t duration_s;
+    int16_t current;            ///< raw CURRREP (156.25 uA per LSB with 10 mOhm)
+    bool charging;
+    uint32_t soc_change_s;      ///< dSOCi period, 0 for none
+
+} Phase;
+
+static const Phase phases[] = {
+    { "idle",       4 * 3600,   -20,    false,  0 },
+    { "transient",  600,        -3200,  false,  0 },
+    { "idle",       2 * 3600,   -20,    false,  0 },
+    { "charge",     3600,       6400,   true,   36 },
+    { "idle",       6 * 3600,   -20,    false,  0 },
+};
+
+int main() {
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    if (!BMS.begin()) {
+        printf("Failed to initialize BMS\n");
+        return 1;
+    }
+
+    poller.begin();
+
+    uint32_t soc_changes = 0;
+
+    printf("%-10s %8s %6s %12s\n", "phase", "time s", "polls", "interval ms");
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        const Phase& phase = phases[i];
+        uint32_t polls = poller.report().polls;
+
+        sim.setRegister(MAX17332_CURRREP_REG, (uint16_t) phase.current);
+        sim.setRegister(MAX17332_FPROTSTAT_REG, phase.charging ? 0 : FPROTSTAT_ISDIS_MASK);
+
+        for (uint32_t t = 0; t < phase.duration_s * 1000; t += STEP_MS) {
+            if (phase.soc_change_s && t % (phase.soc_change_s * 1000) == 0) {
+                sim.setRegister(MAX17332_STATUS_REG, sim.getRegister(MAX17332_STATUS_REG) | STATUS_SOCCHANGE_MASK);
+                soc_changes++;
+            }
+
+            poller.service();
+            hostClockAdvance(STEP_MS * 1000);
+        }
+
+        printf("%-10s %8u %6u %12u\n", phase.name, phase.duration_s, poller.report().polls - polls, poller.interval());
+    }
+
+    MAX17332_AdaptiveReport report = poller.report();
+    printf("POLLS: %u adaptive, %u at the fixed %u ms interval\n", report.polls, report.fixed_polls, MAX17332_ADAPTIVE_MIN_INTERVAL);
+    printf("BUS TIME: %u us spent, %u us saved (%.1f%%)\n", report.bus_us, report.saved_us,
+        100.0 * report.saved_us / (report.bus_us + report.saved_us));
+    printf("SOC CHANGES: %u seen and cleared of %u\n", report.soc_clears, soc_changes);
+
+    return report.soc_clears == soc_changes ? 0 : 1;
+}
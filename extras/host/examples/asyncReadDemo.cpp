@@ -0,0 +1,95 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Split-phase reads on an asynchronous transport plugged in with MAX17332_TRANSPORT_CLASS:
+ * HostAsyncTransport keeps every burst in flight for a few pollRead() calls. Checks that
+ * MAX17332::pollRead() returns MAX17332_PENDING while a burst is in flight, that the loop gets
+ * control back in between, and that the words match a blocking poll(). Exits with 1 otherwise
+*/
+
+#ifndef MAX17332_TRANSPORT_CLASS
+#error "Build with -DMAX17332_TRANSPORT_CLASS=HostAsyncTransport -DMAX17332_TRANSPORT_HEADER='\"HostAsyncTransport.h\"'"
+#endif
+
+#include <stdio.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+
+static const uint16_t registers[] = {
+    MAX17332_VCELL_REG,
+    MAX17332_CURR_REG,
+    MAX17332_TEMP_REG,
+    MAX17332_REPSOC_REG,
+    MAX17332_N_BATT_STATUS_REG,
+};
+
+MAX17332_ReadPlan plan(registers, sizeof(registers) / sizeof(registers[0]));
+
+int main() {
+    uint16_t words[MAX17332_PLAN_MAX_BURST_WORDS];
+    uint16_t expected[MAX17332_PLAN_MAX_BURST_WORDS];
+    int errors = 0;
+
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    if (!BMS.begin()) {
+        printf("Failed to initialize BMS\n");
+        return 1;
+    }
+
+    sim.setRegister(MAX17332_VCELL_REG, 0xC350);
+    sim.setRegister(MAX17332_CURR_REG, 0xFF38);
+    sim.setRegister(MAX17332_TEMP_REG, 0x1900);
+    sim.setRegister(MAX17332_REPSOC_REG, 0x4B00);
+
+    if (BMS.poll(plan, expected) != 1) {
+        printf("Blocking poll failed\n");
+        return 1;
+    }
+
+    for (uint8_t polls = 0; polls <= 4; polls++) {
+        HostAsyncTransport::polls = polls;
+        memset(&HostAsyncTransport::stats, 0, sizeof(HostAsyncTransport::stats));
+
+        if (BMS.startRead(plan, words) != 1) {
+            printf("startRead failed\n");
+            return 1;
+        }
+
+        // Each MAX17332_PENDING hands the loop back to other work
+        uint32_t loops = 0;
+        int ret;
+        while ((ret = BMS.pollRead()) == MAX17332_PENDING) {
+            loops++;
+        }
+
+        uint32_t pending = HostAsyncTransport::stats.pending;
+        bool match = (ret == 1) && memcmp(words, expected, plan.words() * sizeof(uint16_t)) == 0;
+
+        printf("polls %u: %u bursts, %u loop iterations, %u transport PENDING, %s\n", polls,
+               (unsigned) plan.bursts(), (unsigned) loops, (unsigned) pending, match ? "match" : "MISMATCH");
+
+        if (!match || pending != (uint32_t) polls * plan.bursts() || loops < pending) {
+            errors++;
+        }
+    }
+
+    printf("%s\n", errors ? "FAIL" : "OK");
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Bus cost of the public MAX17332 API against the simulated gauge. Every call runs on a freshly
+ * powered-on simulator at 100 kHz and 400 kHz; transactions, bytes on the wire (address bytes
+ * included), modelled bus time and elapsed virtual time (waits included) are printed as CSV,
+ * or JSON with --json. Exits with 1 if a call exceeds its transaction or byte budget, so a
+ * change adding bus traffic to a hot path fails loudly. Budgets are the current costs: lower
+ * them when a call gets cheaper
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+MAX17332_Programmer programmer(BMS);
+
+uint8_t image[NVM_SIZE];
+
+/**
+ * Discards everything written to it
+*/
+class NullPrint : public Print {
+
+    public:
+        size_t write(uint8_t) { return 1; }
+        size_t write(const uint8_t*, size_t length) { return length; }
+
+};
+
+NullPrint null_print;
+
+typedef struct
+{
+    const char* name;
+    void (*setup)();            ///< untimed preparation, may be NULL
+    void (*run)();
+    uint32_t max_transactions;
+    uint32_t max_bytes;
+
+} BenchCase;
+
+static void dumpImage() {
+    BMS.shadowMemDump(image);
+}
+
+static void changedImage() {
+    dumpImage();
+    image[0x1C6 * 2 - NVM_START_ADDRESS * 2] ^= 0x01;
+}
+
+static void knownImage() {
+    dumpImage();
+    BMS.shadowMemFingerprint(NULL);
+}
+
+static const BenchCase cases[] = {
+    { "begin",                      NULL,           []() { BMS.begin(); },                                  4, 10 },
+    { "update",                     NULL,           []() { BMS.update(); },                                 10, 27 },
+    { "snapshot",                   NULL,           []() { BMS.snapshot(); },                               10, 27 },
+    { "readDevName",                NULL,           []() { BMS.readDevName(); },                            2, 5 },
+    { "readVCell",                  NULL,           []() { BMS.readVCell(); },                              2, 5 },
+    { "readCurrent",                NULL,           []() { BMS.readCurrent(); },                            2, 5 },
+    { "readCapacity",               NULL,           []() { BMS.readCapacity(); },                           2, 5 },
+    { "readTemp",                   NULL,           []() { BMS.readTemp(); },                               2, 5 },
+    { "readSoc",                    NULL,           []() { BMS.readSoc(); },                                2, 5 },
+    { "readRSense",                 NULL,           []() { BMS.readRSense(); },                             0, 0 },
+    { "readVCellMicroVolts",        NULL,           []() { BMS.readVCellMicroVolts(); },                    2, 5 },
+    { "readCurrentMicroAmps",       NULL,           []() { BMS.readCurrentMicroAmps(); },                   2, 5 },
+    { "readCapacityMicroAmpHours",  NULL,           []() { BMS.readCapacityMicroAmpHours(); },              2, 5 },
+    { "readTempMilliCelsius",       NULL,           []() { BMS.readTempMilliCelsius(); },                   2, 5 },
+    { "readSocMilliPercent",        NULL,           []() { BMS.readSocMilliPercent(); },                    2, 5 },
+    { "readStatus",                 NULL,           []() { BMS.readStatus(); },                             2, 5 },
+    { "readFProtStat",              NULL,           []() { BMS.readFProtStat(); },                          2, 5 },
+    { "readnBattStatus",            NULL,           []() { BMS.readnBattStatus(); },                        2, 5 },
+    { "readCommStat",               NULL,           []() { BMS.readCommStat(); },                           2, 5 },
+    { "readLocks",                  NULL,           []() { BMS.readLocks(); },                              2, 5 },
+    { "readUserMem1C6",             NULL,           []() { BMS.readUserMem1C6(); },                         2, 5 },
+    { "hasAlerts",                  NULL,           []() { BMS.hasAlerts(); },                              2, 5 },
+    { "readStatusBits",             NULL,           []() { BMS.readStatusBits(); },                         6, 15 },
+    { "refreshStatus",              NULL,           []() { BMS.refreshStatus(); },                          6, 15 },
+    { "clearStatus",                NULL,           []() { BMS.clearStatus(); },                            6, 24 },
+    { "clearStatusBits",            NULL,           []() { BMS.clearStatusBits(STATUS_ALERT_MASK); },       6, 21 },
+    { "writeUserMem1C6",            NULL,           []() { BMS.writeUserMem1C6(0x1234); },                  7, 25 },
+    { "shadowMemDump",              NULL,           []() { BMS.shadowMemDump(image); },                     2, 227 },
+    { "shadowMemDump(Print)",       NULL,           []() { BMS.shadowMemDump(null_print); },                14, 245 },
+    { "snapshotDump",               NULL,           []() { BMS.snapshotDump(null_print); },                 10, 27 },
+    { "shadowMemFingerprint",       NULL,           []() { BMS.shadowMemFingerprint(NULL); },               14, 245 },
+    { "compareWithMem",             dumpImage,      []() { BMS.compareWithMem(image); },                    14, 245 },
+    { "compareWithMem(cached)",     knownImage,     []() { BMS.compareWithMem(image); },                    0, 0 },
+    { "writeShadowMem",             dumpImage,      []() { BMS.writeShadowMem(image); },                    14, 266 },
+    { "writeShadowMemDiff",         changedImage,   []() { BMS.writeShadowMemDiff(image); },                19, 265 },
+    { "writeNVM",                   changedImage,   []() { programmer.writeNVM(image); },                   60, 759 },
+};
+
+#define BENCH_CASES (sizeof(cases) / sizeof(cases[0]))
+
+static const uint32_t clocks[] = { 100000, 400000 };
+
+int main(int argc, char** argv) {
+    bool json = (argc > 1 && strcmp(argv[1], "--json") == 0);
+    int failures = 0;
+
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    if (json) {
+        printf("[\n");
+    } else {
+        printf("call,clock_hz,transactions,bytes,bus_us,elapsed_us,max_transactions,max_bytes,result\n");
+    }
+
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+        for (size_t i = 0; i < BENCH_CASES; i++) {
+            const BenchCase& bench = cases[i];
+
+            // Fresh gauge and no library caches; case 0 measures begin() itself
+            sim.powerOn();
+            Wire.setClock(clocks[c]);
+            BMS.setStatusMaxAge(0);
+            BMS.invalidateFingerprint();
+            if (i > 0) {
+                BMS.begin();
+            }
+            if (bench.setup) {
+                bench.setup();
+            }
+
+            HostWireStats before = Wire.stats;
+            unsigned long start = micros();
+            bench.run();
+            unsigned long elapsed = micros() - start;
+
+            uint32_t transactions = Wire.stats.transactions - before.transactions;
+            uint32_t bytes = Wire.stats.bytes - before.bytes;
+            // Same model as the host TwoWire: 9 clocks per byte plus START/STOP per transaction
+            uint32_t bus_us = (uint32_t) (((uint64_t) bytes * 9 + 2 * transactions) * 1000000 / clocks[c]);
+            bool ok = transactions <= bench.max_transactions && bytes <= bench.max_bytes;
+
+            failures += ok ? 0 : 1;
+
+            if (json) {
+                printf("  {\"call\": \"%s\", \"clock_hz\": %u, \"transactions\": %u, \"bytes\": %u, \"bus_us\": %u, "
+                       "\"elapsed_us\": %lu, \"max_transactions\": %u, \"max_bytes\": %u, \"ok\": %s}%s\n",
+                       bench.name, clocks[c], transactions, bytes, bus_us, elapsed, bench.max_transactions, bench.max_bytes,
+                       ok ? "true" : "false", (c == 1 && i == BENCH_CASES - 1) ? "" : ",");
+            } else {
+                printf("%s,%u,%u,%u,%u,%lu,%u,%u,%s\n", bench.name, clocks[c], transactions, bytes, bus_us, elapsed,
+                       bench.max_transactions, bench.max_bytes, ok ? "OK" : "OVER BUDGET");
+            }
+        }
+    }
+
+    if (json) {
+        printf("]\n");
+    }
+
+    if (failures) {
+        fprintf(stderr, "%d calls over budget\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
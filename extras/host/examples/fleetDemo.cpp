@@ -0,0 +1,103 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Polls five simulated gauges on Wire, four behind a TCA9548 and one directly on the bus, and
+ * reports snapshot throughput and mux channel switches for both fleet policies. Every gauge
+ * carries its own CHGSTAT value, so a snapshot answered by the wrong gauge (a mux channel left
+ * open while the direct gauge is polled) is counted as misrouted and fails the run
+*/
+
+#include <stdio.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+#include "TCA9548_Sim.h"
+
+#define MUXED_GAUGES    4
+#define RUN_TIME        10000       // simulated ms
+#define PERIOD          20          // ms, polling period of each gauge
+
+MAX17332_Sim sims[MUXED_GAUGES + 1];
+TCA9548_Sim tca;
+
+static int run(const char* name, MAX17332_FleetPolicy policy) {
+    MAX17332_Mux mux(Wire);
+    MAX17332* gauges[MUXED_GAUGES + 1];
+    MAX17332_Fleet fleet(policy);
+
+    for (uint8_t i = 0; i <= MUXED_GAUGES; i++) {
+        gauges[i] = new MAX17332(Wire);
+        mux.select(i < MUXED_GAUGES ? i : MAX17332_MUX_NONE);
+        gauges[i]->begin();
+    }
+
+    // Added out of channel order on purpose
+    fleet.add(*gauges[MUXED_GAUGES], PERIOD);
+    for (uint8_t i = 0; i < MUXED_GAUGES; i++) {
+        uint8_t channel = (i * 3) % MUXED_GAUGES;
+        fleet.add(*gauges[channel], PERIOD, &mux, channel);
+    }
+
+    uint32_t start_switches = mux.switches();
+    uint32_t start_transactions = Wire.stats.transactions;
+    unsigned long start = millis();
+    uint32_t idle = 0;
+
+    while (millis() - start < RUN_TIME) {
+        if (fleet.poll() < 0) {
+            idle++;
+            hostClockAdvance(100);
+        }
+    }
+
+    uint32_t errors = 0;
+    uint32_t misrouted = 0;
+    for (uint8_t i = 0; i < fleet.size(); i++) {
+        errors += fleet.result(i).errors;
+        for (uint8_t k = 0; k <= MUXED_GAUGES; k++) {
+            if (&fleet.gauge(i) == gauges[k] && fleet.result(i).status.chg_stat != k) {
+                misrouted++;
+            }
+        }
+    }
+
+    printf("%-12s %6u snapshots (%.1f/s), %5u mux switches, %6u transactions, %u errors, %u misrouted, %u idle polls\n",
+           name, fleet.polls(), fleet.polls() * 1000.0 / RUN_TIME, mux.switches() - start_switches,
+           Wire.stats.transactions - start_transactions, errors, misrouted, idle);
+
+    for (uint8_t i = 0; i <= MUXED_GAUGES; i++) {
+        delete gauges[i];
+    }
+
+    return misrouted ? 0 : 1;
+}
+
+int main() {
+    hostClockSetVirtual(true);
+
+    for (uint8_t i = 0; i <= MUXED_GAUGES; i++) {
+        sims[i].setRegister(MAX17332_CHGSTAT_REG, i);
+        if (i < MUXED_GAUGES) {
+            tca.attach(i, sims[i]);
+        }
+    }
+    // The mux answers first while a channel is open
+    Wire.attach(tca);
+    Wire.attach(sims[MUXED_GAUGES]);
+    Wire.setClock(400000);
+
+    int ok = run("round-robin", MAX17332_FLEET_ROUND_ROBIN);
+    ok &= run("deadline", MAX17332_FLEET_DEADLINE);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Runs the library over the i2c-dev transport against the simulated MAX17332.
+ * Build with -DMAX17332_TRANSPORT_I2CDEV=1. The fake adapter replaces ioctl(), /dev/null stands in for /dev/i2c-N
+*/
+
+#include <stdio.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+#include "HostI2cDev.h"
+
+#if !MAX17332_TRANSPORT_I2CDEV
+#error "Build with -DMAX17332_TRANSPORT_I2CDEV=1"
+#endif
+
+MAX17332_Sim sim;
+MAX17332_I2cDevBus bus("/dev/null", hostI2cDevIoctl);
+MAX17332 BMS(bus);
+
+int main() {
+    hostClockSetVirtual(true);
+    I2cDev.attach(sim);
+
+    if (!BMS.begin()) {
+        printf("Failed to initialize BMS\n");
+        return 1;
+    }
+
+    printf("DEVICE NAME: %04X\n", BMS.readDevName());
+    printf("BATTERY VOLTAGE: %.4f\n", BMS.readVCell());
+
+    uint32_t ioctls = I2cDev.stats.ioctls;
+    uint32_t messages = I2cDev.stats.messages;
+    BMS.snapshot();
+    ioctls = I2cDev.stats.ioctls - ioctls;
+    messages = I2cDev.stats.messages - messages;
+    printf("SNAPSHOT: %u ioctls, %u messages\n", ioctls, messages);
+
+    BMS.writeUserMem1C6(0xafbf);
+    printf("USER MEM 1C6: %04X\n", BMS.readUserMem1C6());
+
+    printf("TOTAL: %u ioctls, %u bytes, %u errors\n", bus.transfers(), I2cDev.stats.bytes, I2cDev.stats.errors);
+
+    BMS.end();
+
+    return 0;
+}
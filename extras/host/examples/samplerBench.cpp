@@ -0,0 +1,149 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * MAX17332_Sampler with std::thread readers. One writer thread samples the simulated gauge as
+ * fast as it can, stamping every sample into VCELLREP and CHGSTAT; reader threads copy the
+ * published reading and check both words against the sample count, so a torn copy is caught.
+ * The same load runs against a std::mutex protected copy for comparison. Exits with 1 on a torn read
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+#define BENCH_DURATION_MS   300
+#define BENCH_MAX_READERS   4
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+MAX17332_Sampler sampler(BMS);
+
+std::mutex lock;
+MAX17332_Reading locked_reading;
+
+typedef struct
+{
+    uint64_t samples;
+    uint64_t reads;
+    uint64_t busy;          ///< read() gave up on a publishing writer
+    uint64_t torn;
+
+} BenchResult;
+
+static bool consistent(const MAX17332_Reading& reading) {
+    return reading.sample.vcell == (uint16_t) reading.count && reading.status.chg_stat == (int) (uint16_t) reading.count;
+}
+
+static void stamp() {
+    uint16_t next = (uint16_t) (sampler.count() + 1);
+
+    sim.setRegister(MAX17332_VCELLREP_REG, next);
+    sim.setRegister(MAX17332_CHGSTAT_REG, next);
+}
+
+static BenchResult run(int readers, bool use_mutex) {
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    std::vector<BenchResult> results(readers);
+    BenchResult total;
+
+    memset(&total, 0, sizeof(total));
+
+    for (int i = 0; i < readers; i++) {
+        BenchResult* result = &results[i];
+        memset(result, 0, sizeof(*result));
+
+        threads.push_back(std::thread([result, &stop, use_mutex]() {
+            MAX17332_Reading reading;
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (use_mutex) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    reading = locked_reading;
+                } else if (!sampler.read(reading)) {
+                    result->busy++;
+                    continue;
+                }
+
+                result->reads++;
+                if (!consistent(reading)) {
+                    result->torn++;
+                }
+            }
+        }));
+    }
+
+    // The calling thread owns the gauge
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(BENCH_DURATION_MS)) {
+        stamp();
+        sampler.sample();
+
+        if (use_mutex) {
+            MAX17332_Reading reading;
+            sampler.tryRead(reading);
+            std::lock_guard<std::mutex> guard(lock);
+            locked_reading = reading;
+        }
+
+        total.samples++;
+    }
+
+    stop = true;
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+        total.reads += results[i].reads;
+        total.busy += results[i].busy;
+        total.torn += results[i].torn;
+    }
+
+    return total;
+}
+
+int main() {
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    if (!BMS.begin()) {
+        printf("Failed to initialize BMS\n");
+        return 1;
+    }
+
+    // Publish a first consistent reading for the mutex copy
+    stamp();
+    sampler.sample();
+    sampler.tryRead(locked_reading);
+
+    uint64_t torn = 0;
+
+    printf("mode,readers,samples/s,reads/s,busy,torn\n");
+    for (int readers = 1; readers <= BENCH_MAX_READERS; readers *= 2) {
+        for (int use_mutex = 0; use_mutex < 2; use_mutex++) {
+            BenchResult result = run(readers, use_mutex);
+            printf("%s,%d,%.0f,%.0f,%llu,%llu\n", use_mutex ? "mutex" : "seqlock", readers,
+                result.samples * 1000.0 / BENCH_DURATION_MS, result.reads * 1000.0 / BENCH_DURATION_MS,
+                (unsigned long long) result.busy, (unsigned long long) result.torn);
+            torn += result.torn;
+        }
+    }
+
+    return torn ? 1 : 0;
+}
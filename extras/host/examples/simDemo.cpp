@@ -0,0 +1,58 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Runs the library against the simulated MAX17332 on the host
+*/
+
+#include <stdio.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+MAX17332_Programmer programmer(BMS);
+
+int main() {
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    if (!BMS.begin()) {
+        printf("Failed to initialize BMS\n");
+        return 1;
+    }
+
+    printf("DEVICE NAME: %04X\n", BMS.readDevName());
+    printf("BATTERY VOLTAGE: %.4f\n", BMS.readVCell());
+    printf("RSENSE VALUE: %.2f\n", BMS.readRSense());
+    printf("CURRENT: %.6f\n", BMS.readCurrent());
+    printf("TEMPERATURE: %.4f\n", BMS.readTemp());
+    printf("STATE OF CHARGE %%: %.4f\n", BMS.readSoc());
+
+    MAX17332_BusUsage usage;
+    BMS.snapshot(&usage);
+    printf("SNAPSHOT: %u transactions, %u bytes\n", usage.transactions, usage.bytes);
+
+    BMS.writeUserMem1C6(0xafbf);
+    printf("USER MEM 1C6: %04X (firmware resets: %u)\n", BMS.readUserMem1C6(), sim.firmwareResets());
+
+    uint8_t image[NVM_SIZE];
+    BMS.shadowMemDump(image);
+    image[0] = 0x5A;
+
+    unsigned long start = millis();
+    int ret = programmer.writeNVM(image);
+    printf("WRITE NVM: %d in %lu simulated ms (NVM writes: %u, locked: %d)\n", ret, millis() - start, sim.nvmWrites(), sim.isLocked());
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Checks MAX17332::busStats() against the traffic counted by the Wire shim: for each call the
+ * transactions, bytes (plus one address byte per transaction) and NACKs recorded by the driver
+ * must match Wire.stats, in total and per bank. Build with -DMAX17332_BUS_STATS=1. Exits with 1
+ * on a mismatch
+*/
+
+#if !MAX17332_BUS_STATS
+#error "Build with -DMAX17332_BUS_STATS=1"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino_MAX17332.h>
+#include "MAX17332_Sim.h"
+
+MAX17332_Sim sim;
+MAX17332 BMS(Wire);
+MAX17332_Programmer programmer(BMS);
+
+uint8_t image[NVM_SIZE];
+uint16_t words[MAX17332_PLAN_MAX_BURST_WORDS];
+
+static const uint16_t registers[] = {
+    MAX17332_VCELL_REG,
+    MAX17332_TEMP_REG,
+    MAX17332_N_BATT_STATUS_REG,
+};
+
+MAX17332_ReadPlan plan(registers, sizeof(registers) / sizeof(registers[0]));
+
+typedef struct
+{
+    const char* name;
+    void (*run)();
+
+} CheckCase;
+
+static void changedImage() {
+    BMS.shadowMemDump(image);
+    image[0x1C6 * 2 - NVM_START_ADDRESS * 2] ^= 0x01;
+}
+
+static const CheckCase cases[] = {
+    { "begin",              []() { BMS.begin(); } },
+    { "snapshot",           []() { BMS.snapshot(); } },
+    { "readVCell",          []() { BMS.readVCell(); } },
+    { "refreshStatus",      []() { BMS.refreshStatus(); } },
+    { "clearStatusBits",    []() { sim.setRegister(MAX17332_STATUS_REG, STATUS_ALERT_MASK); BMS.clearStatusBits(STATUS_ALERT_MASK); } },
+    { "writeUserMem1C6",    []() { BMS.writeUserMem1C6(0x1234); } },
+    { "shadowMemDump",      []() { BMS.shadowMemDump(image); } },
+    { "writeShadowMemDiff", []() { changedImage(); BMS.writeShadowMemDiff(image); } },
+    { "writeNVM",           []() { changedImage(); programmer.writeNVM(image); } },
+    { "startRead/pollRead", []() { BMS.startRead(plan, words); while (BMS.pollRead() == MAX17332_PENDING); } },
+    { "readVCell(absent)",  []() { sim.setPresent(false); BMS.readVCell(); sim.setPresent(true); } },
+    { "writeUserMem1C6(absent)", []() { sim.setPresent(false); BMS.writeUserMem1C6(0x1234); sim.setPresent(true); } },
+    { "pollRead(absent)",   []() { sim.setPresent(false); BMS.startRead(plan, words); while (BMS.pollRead() == MAX17332_PENDING); sim.setPresent(true); } },
+};
+
+static MAX17332_BusCounters sum(const MAX17332_BusCounters* counters, size_t count) {
+    MAX17332_BusCounters total;
+
+    memset(&total, 0, sizeof(total));
+    for (size_t i = 0; i < count; i++) {
+        total.transactions += counters[i].transactions;
+        total.bytes += counters[i].bytes;
+        total.nacks += counters[i].nacks;
+    }
+
+    return total;
+}
+
+static bool same(const MAX17332_BusCounters& a, const MAX17332_BusCounters& b) {
+    return a.transactions == b.transactions && a.bytes == b.bytes && a.nacks == b.nacks;
+}
+
+int main() {
+    int errors = 0;
+
+    hostClockSetVirtual(true);
+    Wire.attach(sim);
+
+    printf("call,wire transactions,wire bytes,wire nacks,stats transactions,stats bytes,stats nacks\n");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        memset(&Wire.stats, 0, sizeof(Wire.stats));
+        BMS.resetBusStats();
+
+        cases[i].run();
+
+        const MAX17332_BusStats& stats = BMS.busStats();
+        MAX17332_BusCounters ops = sum(stats.op, MAX17332_OP_COUNT);
+        MAX17332_BusCounters banks = sum(stats.bank, 2);
+        MAX17332_BusCounters wire;
+
+        // The driver counts register and data bytes, the shim also the address byte of each transaction
+        memset(&wire, 0, sizeof(wire));
+        wire.transactions = Wire.stats.transactions;
+        wire.bytes = Wire.stats.bytes - Wire.stats.transactions;
+        wire.nacks = Wire.stats.nacks;
+
+        bool ok = same(ops, wire) && same(banks, wire);
+        printf("%s,%u,%u,%u,%u,%u,%u%s\n", cases[i].name, (unsigned) wire.transactions, (unsigned) wire.bytes,
+               (unsigned) wire.nacks, (unsigned) ops.transactions, (unsigned) ops.bytes, (unsigned) ops.nacks,
+               ok ? "" : ",MISMATCH");
+        if (!ok) {
+            errors++;
+        }
+    }
+
+    printf("%s\n", errors ? "FAIL" : "OK");
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+/**
+ * Round trip of MAX17332_Telemetry: appends pseudo-random samples (steady steps, jitter, large
+ * time jumps, full scale deltas) to small logs and checks that MAX17332_TelemetryReader returns
+ * exactly the retained samples. Exits with 1 on a mismatch
+*/
+
+#include <stdio.h>
+#include <vector>
+
+#include <Arduino_MAX17332.h>
+
+MAX17332 BMS(Wire);
+
+static uint32_t seed = 1;
+
+static uint32_t next() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static bool same(const MAX17332_Sample& a, const MAX17332_Sample& b) {
+    return a.timestamp == b.timestamp && a.vcell == b.vcell && a.current == b.current &&
+           a.temp == b.temp && a.soc == b.soc;
+}
+
+static uint32_t step(uint32_t i) {
+    switch (next() % 8) {
+        case 0: return 0;                               // same millis()
+        case 1: return next() % 3000000;                // beyond the dt delta limit
+        case 2: return 100 + next() % 50;               // jitter
+        default: return (i & 256) ? 1000 : 100;         // steady
+    }
+}
+
+static uint16_t field(uint16_t last) {
+    switch (next() % 8) {
+        case 0: return next();                          // full scale jump
+        case 1: return last;
+        default: return last + (int16_t) (next() % 33) - 16;
+    }
+}
+
+// Returns the number of mismatches
+static int check(size_t size, uint32_t samples) {
+    std::vector<uint8_t> buffer(size);
+    std::vector<MAX17332_Sample> history;
+    MAX17332_Telemetry log(BMS, buffer.data(), size);
+    MAX17332_Sample sample = { 0xFFFF0000, 0, 0, 0, 0 };        // crosses the millis() wrap
+    int errors = 0;
+
+    for (uint32_t i = 0; i < samples; i++) {
+        sample.timestamp += step(i);
+        sample.vcell = field(sample.vcell);
+        sample.current = field(sample.current);
+        sample.temp = field(sample.temp);
+        sample.soc = field(sample.soc);
+
+        if (log.append(sample) != 1) {
+            printf("size %u: append %u failed\n", (unsigned) size, i);
+            return errors + 1;
+        }
+        history.push_back(sample);
+
+        if (log.used() > log.capacity() || log.records() > history.size()) {
+            printf("size %u: %u bytes, %u records after %u appends\n", (unsigned) size,
+                   (unsigned) log.used(), (unsigned) log.records(), i + 1);
+            return errors + 1;
+        }
+
+        // Segments are a fraction of the buffer: an eviction never leaves a single record
+        if (log.evictions() && size >= MAX17332_TELEMETRY_KEYFRAME_SIZE * MAX17332_TELEMETRY_SEGMENTS && log.records() < 2) {
+            printf("size %u: %u record left after %u appends\n", (unsigned) size, (unsigned) log.records(), i + 1);
+            return errors + 1;
+        }
+
+        if (i % 97 != 0 && i != samples - 1) {
+            continue;
+        }
+
+        // The log keeps the newest records()
+        MAX17332_TelemetryReader reader(log);
+        MAX17332_Sample decoded;
+        size_t first = history.size() - log.records();
+        size_t count = 0;
+
+        while (reader.read(decoded) == 1) {
+            if (first + count >= history.size() || !same(decoded, history[first + count])) {
+                errors++;
+                break;
+            }
+            count++;
+        }
+        if (count != log.records()) {
+            printf("size %u: decoded %u of %u records after %u appends\n", (unsigned) size,
+                   (unsigned) count, (unsigned) log.records(), i + 1);
+            errors++;
+        }
+    }
+
+    // An eviction invalidates an open reader
+    MAX17332_TelemetryReader reader(log);
+    uint32_t evictions = log.evictions();
+    while (log.evictions() == evictions) {
+        sample.timestamp += 100;
+        log.append(sample);
+    }
+    if (reader.read(sample) != 0) {
+        printf("size %u: reader not invalidated by an eviction\n", (unsigned) size);
+        errors++;
+    }
+
+    printf("size %u: %u appends, %u records kept in %u bytes, %u evictions, %d errors\n",
+           (unsigned) size, samples, (unsigned) log.records(), (unsigned) log.used(),
+           (unsigned) log.evictions(), errors);
+
+    return errors;
+}
+
+int main() {
+    static const size_t sizes[] = { MAX17332_TELEMETRY_KEYFRAME_SIZE, 64, 300, 1024, 4096 };
+    int errors = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        errors += check(sizes[i], 20000);
+    }
+
+    // A buffer that cannot hold a keyframe
+    uint8_t tiny[MAX17332_TELEMETRY_KEYFRAME_SIZE - 1];
+    MAX17332_Telemetry log(BMS, tiny, sizeof(tiny));
+    MAX17332_Sample sample = { 0, 0, 0, 0, 0 };
+    if (log.append(sample) != -1) {
+        printf("size %u: append accepted\n", (unsigned) sizeof(tiny));
+        errors++;
+    }
+
+    printf("%s\n", errors ? "FAIL" : "OK");
+
+    return errors ? 1 : 0;
+}
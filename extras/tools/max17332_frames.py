@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+#   Arduino MAX17332 library
+#
+#   Copyright (c) 2023 Arduino SA
+#
+#   This Source Code Form is subject to the terms of the Mozilla Public
+#   License, v. 2.0. If a copy of the MPL was not distributed with this
+#   file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+"""Decodes MAX17332 binary frames (see src/MAX17332_Frame.h) from a capture file or a serial port.
+
+Shadow RAM frames are written as NVM images (.bin) and printed as a C array ready for
+writeShadowMem(), or with --base as a MAX17332_NvmBase dump struct; register frames are printed
+as tables.
+
+    max17332_frames.py capture.bin
+    max17332_frames.py --port /dev/ttyACM0 --baud 9600 --count 1
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"\xa5\x17"
+HEADER = struct.Struct("<BHH")          # type, address, length
+FRAME_BLOCK = 0x01
+FRAME_REGISTERS = 0x02
+NVM_START_ADDRESS = 0x180
+NVM_SIZE = 224
+
+REGISTER_NAMES = {
+    0x000: "STATUS", 0x005: "REPCAP", 0x006: "REPSOC", 0x00E: "AVSOC", 0x012: "VCELLREP",
+    0x01A: "VCELL", 0x01B: "TEMP", 0x01C: "CURR", 0x021: "DEVNAME", 0x022: "CURRREP",
+    0x061: "COMMSTAT", 0x0A3: "CHGSTAT", 0x0AB: "CONFIG2", 0x0AF: "PROT_ALRT",
+    0x0D9: "PROT_STATUS", 0x0DA: "FPROTSTAT", 0x19C: "nRSENSE", 0x1A8: "nBATT_STATUS",
+    0x1C6: "USERMEM_1C6", 0x1E0: "USERMEM_1E0",
+}
+
+
+def frames(stream):
+    """Yields (type, address, payload) for every frame with a valid CRC, resynchronising on the magic."""
+    buffer = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if getattr(stream, "timeout", None) is not None:
+                continue                # serial port: nothing within the timeout, keep listening
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(MAGIC)
+            if start < 0:
+                buffer = buffer[-1:]
+                break
+            buffer = buffer[start:]
+            if len(buffer) < 2 + HEADER.size:
+                break
+            kind, address, length = HEADER.unpack_from(buffer, 2)
+            end = 2 + HEADER.size + length + 4
+            if len(buffer) < end:
+                break
+            body = buffer[2:end - 4]
+            (crc,) = struct.unpack_from("<I", buffer, end - 4)
+            if zlib.crc32(body) & 0xFFFFFFFF != crc:
+                sys.stderr.write("bad CRC, resynchronising\n")
+                buffer = buffer[1:]
+                continue
+            buffer = buffer[end:]
+            yield kind, address, body[HEADER.size:]
+
+
+def c_array(image, base=None):
+    lines = []
+    for page in range(0, len(image), 32):
+        lines.append("    " + " ".join("0x%02x," % b for b in image[page:page + 32]))
+    if base:
+        # Base image for MAX17332_NvmPatch<MAX17332_NvmBase<name>, ...>
+        return ("struct %s {\n    static constexpr uint8_t data[NVM_SIZE] = {\n    " % base +
+                "\n    ".join(lines) + "\n    };\n};\nconstexpr uint8_t %s::data[NVM_SIZE];" % base)
+    return "const uint8_t nvm[NVM_SIZE] = {\n" + "\n".join(lines) + "\n};"
+
+
+def print_table(pairs):
+    print("%-6s %-14s %-6s" % ("REG", "NAME", "VALUE"))
+    for register, value in pairs:
+        print("0x%03X  %-14s 0x%04X" % (register, REGISTER_NAMES.get(register, "?"), value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="capture file (default: stdin)")
+    parser.add_argument("--port", help="serial port, needs pyserial")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--count", type=int, default=0, help="stop after this many frames")
+    parser.add_argument("--prefix", default="shadow", help="shadow RAM image file prefix")
+    parser.add_argument("--base", metavar="NAME", help="print shadow RAM images as a MAX17332_NvmBase dump struct")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        # The timeout returns partial reads, so a frame is decoded as soon as it is complete
+        stream = serial.Serial(args.port, args.baud, timeout=0.1)
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    decoded = 0
+    for kind, address, payload in frames(stream):
+        if kind == FRAME_BLOCK and address == NVM_START_ADDRESS and len(payload) == NVM_SIZE:
+            name = "%s_%d.bin" % (args.prefix, decoded)
+            with open(name, "wb") as image:
+                image.write(payload)
+            print("shadow RAM -> %s" % name)
+            print(c_array(payload, args.base))
+        elif kind == FRAME_BLOCK:
+            words = struct.unpack("<%dH" % (len(payload) // 2), payload)
+            print_table((address + i, value) for i, value in enumerate(words))
+        elif kind == FRAME_REGISTERS:
+            print_table(struct.iter_unpack("<HH", payload))
+        else:
+            sys.stderr.write("unknown frame type 0x%02X\n" % kind)
+        decoded += 1
+        if args.count and decoded >= args.count:
+            break
+
+
+if __name__ == "__main__":
+    main()
@@ -14,6 +14,18 @@
 #define  _ARDUINO_MAX17332_H_
 
 #include "MAX17332.h"
+#include "MAX17332_ReadPlan.h"
+#include "MAX17332_BusStats.h"
+#include "MAX17332_Registers.h"
+#include "MAX17332_Fingerprint.h"
+#include "MAX17332_NvmImage.h"
+#include "MAX17332_Fleet.h"
+#include "MAX17332_Events.h"
+#include "MAX17332_Telemetry.h"
+#include "MAX17332_Sampler.h"
+#include "MAX17332_Adaptive.h"
+#include "MAX17332_Frame.h"
+#include "MAX17332_WriteSession.h"
 #include "MAX17332_Programmer.h"
 
 #endif
\ No newline at end of file
@@ -11,32 +11,230 @@
 */
 
 #include "MAX17332.h"
+#include "MAX17332_Registers.h"
+#include "MAX17332_Fingerprint.h"
+#include "MAX17332_Frame.h"
+#include "MAX17332_WriteSession.h"
 
-MAX17332::MAX17332(TwoWire& wire, uint16_t address_l, uint16_t address_h): _wire(&wire), _address_l(address_l), _address_h(address_h) {}
-MAX17332::~MAX17332(){}
+/**
+ * Registers read by snapshot()
+*/
+static const uint16_t snapshot_registers[] = {
+    MAX17332_STATUS_REG,
+    MAX17332_FPROTSTAT_REG,
+    MAX17332_N_BATT_STATUS_REG,
+    MAX17332_PROT_STATUS_REG,
+    MAX17332_PROT_ALRT_REG,
+    MAX17332_CHGSTAT_REG,
+};
+
+#define SNAPSHOT_REGISTERS  (sizeof(snapshot_registers) / sizeof(snapshot_registers[0]))
+
+#define NVM_WORDS           (NVM_SIZE / 2)
+#define NVM_ROMID_WORD      (NVM_ROMID_OFFSET / 2)
+#define NVM_ROMID_WORDS     (NVM_ROMID_SIZE / 2)
+
+// STATUS CACHE INDEXES
+#define MAX17332_CACHE_STATUS       0
+#define MAX17332_CACHE_FPROTSTAT    1
+#define MAX17332_CACHE_NBATTSTATUS  2
+
+static const uint16_t cache_registers[] = {
+    MAX17332_STATUS_REG,
+    MAX17332_FPROTSTAT_REG,
+    MAX17332_N_BATT_STATUS_REG,
+};
+
+#if MAX17332_BUS_STATS
+// Outside the class, so its layout is the same with and without MAX17332_BUS_STATS
+static MAX17332_BusStats stats_pool[MAX17332_BUS_STATS_INSTANCES];
+static const MAX17332* stats_owner[MAX17332_BUS_STATS_INSTANCES];
+#endif
+
+MAX17332::MAX17332(MAX17332_Transport::Bus& bus, uint16_t address_l, uint16_t address_h): _address_l(address_l), _address_h(address_h), _transport(bus),
+    _snapshot_plan(snapshot_registers, SNAPSHOT_REGISTERS),
+    _status_plan(cache_registers, sizeof(cache_registers) / sizeof(cache_registers[0])), _read_plan(NULL), _read_buffer(NULL), _read_burst(0),
+    _read_in_flight(false), _read_ret(-1), _usage(NULL), _read_start(0), _status_valid(0), _status_max_age(MAX17332_STATUS_MAX_AGE),
+    _wait_timeout(MAX17332_WAIT_TIMEOUT), _wait_poll_interval(MAX17332_WAIT_POLL_INTERVAL), _wait_polls(0),
+    _fingerprint(0), _fingerprint_n_batt_status(0), _fingerprint_valid(false), _stats(NULL) {
+    memset(&_read_usage, 0, sizeof(_read_usage));
+    setRSense(RSENSE_DEFAULT_UOHM);
+#if MAX17332_BUS_STATS
+    for (uint8_t i = 0; i < MAX17332_BUS_STATS_INSTANCES; i++) {
+        if (!stats_owner[i]) {
+            stats_owner[i] = this;
+            _stats = &stats_pool[i];
+            break;
+        }
+    }
+    resetBusStats();
+#endif
+}
+MAX17332::~MAX17332(){
+#if MAX17332_BUS_STATS
+    if (_stats) {
+        stats_owner[_stats - stats_pool] = NULL;
+    }
+#endif
+}
 
 int MAX17332::begin() {
-    _wire->begin();
+    _transport.begin();
 
     if (readDevName() != MAX17332_DEVICE_NAME){
         end();
         return 0;
     }
 
+    calibrate();
+
     return 1;
 }
 
 void MAX17332::end() {
-    _wire->end();
+    _transport.end();
 }
 
 void MAX17332::update() {
-    status.status_reg =  readRegister(MAX17332_STATUS_REG);
-    status.f_prot_stat = readRegister(MAX17332_FPROTSTAT_REG);
-    status.n_batt_status = readRegister(MAX17332_N_BATT_STATUS_REG);
-    status.prot_status = readRegister(MAX17332_PROT_STATUS_REG);
-    status.prot_alrt = readRegister(MAX17332_PROT_ALRT_REG);
-    status.chg_stat = readRegister(MAX17332_CHGSTAT_REG);
+    snapshot();
+}
+
+int MAX17332::snapshot(MAX17332_BusUsage* usage) {
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+    MAX17332_BusUsage local;
+
+    if (!usage) {
+        usage = &local;
+    }
+
+    int ret = poll(_snapshot_plan, words, usage);
+
+    status.status_reg = _snapshot_plan.value(words, MAX17332_STATUS_REG, usage->failed);
+    status.f_prot_stat = _snapshot_plan.value(words, MAX17332_FPROTSTAT_REG, usage->failed);
+    status.n_batt_status = _snapshot_plan.value(words, MAX17332_N_BATT_STATUS_REG, usage->failed);
+    status.prot_status = _snapshot_plan.value(words, MAX17332_PROT_STATUS_REG, usage->failed);
+    status.prot_alrt = _snapshot_plan.value(words, MAX17332_PROT_ALRT_REG, usage->failed);
+    status.chg_stat = _snapshot_plan.value(words, MAX17332_CHGSTAT_REG, usage->failed);
+
+    cacheStatus(MAX17332_CACHE_STATUS, status.status_reg);
+    cacheStatus(MAX17332_CACHE_FPROTSTAT, status.f_prot_stat);
+    cacheStatus(MAX17332_CACHE_NBATTSTATUS, status.n_batt_status);
+
+    return ret;
+}
+
+int MAX17332::poll(const MAX17332_ReadPlan& plan, uint16_t* buffer, MAX17332_BusUsage* usage) {
+    int ret = 1;
+
+    if (!plan.built()) {
+        return -1;
+    }
+
+    if (usage) {
+        memset(usage, 0, sizeof(*usage));
+    }
+
+    for (size_t i = 0; i < plan.bursts(); i++) {
+        const MAX17332_Burst& burst = plan.burst(i);
+        size_t length = burst.words * sizeof(uint16_t);
+        uint16_t* words = &buffer[burst.offset];
+
+        bool ok = (readRegisters(burst.address, (uint8_t*) words, length) == 1);
+
+        if (!ok) {
+            for (uint8_t j = 0; j < burst.words; j++) {
+                words[j] = 0xffff;
+            }
+            ret = 0;
+        }
+
+        if (usage) {
+            usage->transactions++;
+            usage->bytes += ok ? length : 0;
+            usage->failed |= ok ? 0 : (1 << i);
+        }
+    }
+
+    return ret;
+}
+
+int MAX17332::startRead(const MAX17332_ReadPlan& plan, uint16_t* buffer) {
+
+    if (!plan.built()) {
+        return -1;
+    }
+
+    if (_read_ret == MAX17332_PENDING) {
+        return 0;
+    }
+
+    _read_plan = &plan;
+    _read_buffer = buffer;
+    _read_burst = 0;
+    _read_in_flight = false;
+    _read_ret = plan.bursts() ? MAX17332_PENDING : 1;
+    memset(&_read_usage, 0, sizeof(_read_usage));
+
+    return 1;
+}
+
+int MAX17332::pollRead() {
+
+    if (_read_ret != MAX17332_PENDING) {
+        return _read_ret;
+    }
+
+    if (_read_in_flight) {
+        size_t i = _read_burst - 1;
+        const MAX17332_Burst& burst = _read_plan->burst(i);
+        size_t length = burst.words * sizeof(uint16_t);
+
+        int ret = _transport.pollRead();
+        if (ret == MAX17332_TRANSPORT_PENDING) {
+            return MAX17332_PENDING;
+        }
+
+#if MAX17332_BUS_STATS
+        MAX17332_statsRecord(_stats, MAX17332_OP_READ, burst.address, ret == -1 ? 1 : 2, ret == 1 ? 1 + length : (ret == -1 ? 0 : 1),
+            ret == 1 ? MAX17332_STATS_OK : (ret == -1 ? MAX17332_STATS_NACK : MAX17332_STATS_SHORT_READ), micros() - _read_start);
+#endif
+
+        bool ok = (ret == 1);
+        if (!ok) {
+            uint16_t* words = &_read_buffer[burst.offset];
+            for (uint8_t j = 0; j < burst.words; j++) {
+                words[j] = 0xffff;
+            }
+        }
+
+        _read_usage.transactions++;
+        _read_usage.bytes += ok ? length : 0;
+        _read_usage.failed |= ok ? 0 : (1 << i);
+        _read_in_flight = false;
+
+        if (_read_burst == _read_plan->bursts()) {
+            _read_ret = _read_usage.failed ? 0 : 1;
+            return _read_ret;
+        }
+    }
+
+    // At most one burst per call, so a blocking transport stalls the caller for one burst only
+    const MAX17332_Burst& burst = _read_plan->burst(_read_burst++);
+
+    _read_start = micros();
+    _read_in_flight = true;
+    _transport.beginRead(get_i2c_address(burst.address), burst.address & 0xFF,
+        (uint8_t*) &_read_buffer[burst.offset], burst.words * sizeof(uint16_t));
+
+    return MAX17332_PENDING;
+}
+
+int MAX17332::readResult(MAX17332_BusUsage* usage) {
+    if (usage) {
+        *usage = _read_usage;
+    }
+
+    return _read_ret;
 }
 
 uint8_t MAX17332::get_i2c_address(uint16_t reg_address)
@@ -52,22 +250,27 @@ uint8_t MAX17332::get_i2c_address(uint16_t reg_address)
 
 int MAX17332::readRegisters(uint16_t address, uint8_t* data, size_t length)
 {
+    return readRegistersAt(get_i2c_address(address), address, data, length);
+}
+
+int MAX17332::readRegistersAt(uint8_t i2c_address, uint16_t address, uint8_t* data, size_t length)
+{
+    MAX17332_STATS_START();
 
-    uint8_t i2c_address = get_i2c_address(address);
-    _wire->beginTransmission(i2c_address);
-    _wire->write(address & 0xFF);
+    int ret = _transport.read(i2c_address, address & 0xFF, data, length);
+    countUsage(false, length, ret == 1);
 
-    if (_wire->endTransmission(false) != 0) {
+    if (ret == -1) {
+        MAX17332_STATS_RECORD(MAX17332_OP_READ, address, 1, 0, MAX17332_STATS_NACK);
         return -1;
     }
 
-    if (_wire->requestFrom(i2c_address, length) != length) {
+    if (ret != 1) {
+        MAX17332_STATS_RECORD(MAX17332_OP_READ, address, 2, 1, MAX17332_STATS_SHORT_READ);
         return 0;
     }
 
-    for (size_t i = 0; i < length; i++) {
-        *data++ = _wire->read();
-    }
+    MAX17332_STATS_RECORD(MAX17332_OP_READ, address, 2, 1 + length, MAX17332_STATS_OK);
 
     return 1;
 }
@@ -85,79 +288,82 @@ int MAX17332::readRegister(uint16_t address)
 
 int MAX17332::writeRegister(uint16_t address, uint16_t value)
 {
-    uint8_t i2c_address = get_i2c_address(address);
-    _wire->beginTransmission(i2c_address);
-    _wire->write(address & 0xFF);
-    _wire->write(value & 0xFF);         // write LSB
-    _wire->write((value >> 8) & 0xFF);  // write MSB
-    if (_wire->endTransmission() != 0) {
+    MAX17332_STATS_START();
+
+    // Shadow RAM writes and commands (recall, reset) invalidate the cached fingerprint
+    if (address >= NVM_START_ADDRESS || address == MAX17332_COMMAND_REG) {
+        _fingerprint_valid = false;
+    }
+
+    if (writeWordAt(get_i2c_address(address), address, value) != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_WRITE, address, 1, 0, MAX17332_STATS_NACK);
       return 0;
     }
 
+    MAX17332_STATS_RECORD(MAX17332_OP_WRITE, address, 1, 3, MAX17332_STATS_OK);
+
     return 1;
 }
 
 int MAX17332::writeRegisters(uint16_t address, const uint8_t* data, const uint32_t length)
 {
-    uint8_t i2c_address = get_i2c_address(address);
-    _wire->beginTransmission(i2c_address);
-    _wire->write(address & 0xFF);
+    MAX17332_STATS_START();
 
-    for (uint32_t i=0; i<length; i++) {
-        _wire->write(data[i]);
+    if (address + length / 2 > NVM_START_ADDRESS) {
+        _fingerprint_valid = false;
     }
 
-    if (_wire->endTransmission() != 0) {
+    int ret = _transport.write(get_i2c_address(address), address & 0xFF, data, length);
+    countUsage(true, length, ret == 1);
+
+    if (ret != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_WRITE_BURST, address, 1, 0, MAX17332_STATS_NACK);
       return 0;
     }
 
+    MAX17332_STATS_RECORD(MAX17332_OP_WRITE_BURST, address, 1, 1 + length, MAX17332_STATS_OK);
+
     return 1;
 }
 
 int MAX17332::freeMem() {
+    MAX17332_STATS_START();
 
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0x00);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeWordAt(_address_l, MAX17332_COMMSTAT_REG, 0x0000) != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_FREE_MEM, MAX17332_COMMSTAT_REG, 1, 0, MAX17332_STATS_NACK);
       return 0;
     }
 
     // MUST BE DONE TWICE
 
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0x00);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeWordAt(_address_l, MAX17332_COMMSTAT_REG, 0x0000) != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_FREE_MEM, MAX17332_COMMSTAT_REG, 2, 3, MAX17332_STATS_NACK);
       return 0;
     }
 
+    MAX17332_STATS_RECORD(MAX17332_OP_FREE_MEM, MAX17332_COMMSTAT_REG, 2, 6, MAX17332_STATS_OK);
+
     return 1;
 
 }
 
 int MAX17332::protectMem() {
+    MAX17332_STATS_START();
 
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0xF9);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeWordAt(_address_l, MAX17332_COMMSTAT_REG, 0x00F9) != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_PROTECT_MEM, MAX17332_COMMSTAT_REG, 1, 0, MAX17332_STATS_NACK);
       return 0;
     }
 
     // MUST BE DONE TWICE
 
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0xF9);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeWordAt(_address_l, MAX17332_COMMSTAT_REG, 0x00F9) != 1) {
+      MAX17332_STATS_RECORD(MAX17332_OP_PROTECT_MEM, MAX17332_COMMSTAT_REG, 2, 3, MAX17332_STATS_NACK);
       return 0;
     }
 
+    MAX17332_STATS_RECORD(MAX17332_OP_PROTECT_MEM, MAX17332_COMMSTAT_REG, 2, 6, MAX17332_STATS_OK);
+
     return 1;
 }
 
@@ -167,6 +373,11 @@ int MAX17332::writeNVM(const uint8_t* data) {
         return 2;
     }
 
+    return copyNVM(data);
+}
+
+int MAX17332::copyNVM(const uint8_t* data) {
+
     freeMem();
 
     if (!writeRegisters(NVM_START_ADDRESS, data, NVM_SIZE)) {
@@ -176,11 +387,7 @@ int MAX17332::writeNVM(const uint8_t* data) {
     // Verify memory write
 
     // Clear CommStat.NVError flag
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0x00);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeRegister(MAX17332_COMMSTAT_REG, 0x0000) != 1) {
       return 0;
     }
 
@@ -191,7 +398,10 @@ int MAX17332::writeNVM(const uint8_t* data) {
     delay(TBLOCK);
 
     // Wait for CommStat.NVBusy to clear
-    while ((readCommStat() & COMMSTAT_NVBUSY_MASK) != 0);
+    if (waitCleared(MAX17332_COMMSTAT_REG, COMMSTAT_NVBUSY_MASK) != 1) {
+        protectMem();
+        return MAX17332_TIMEOUT;
+    }
 
     // Check CommStat.NVError flag
     if ((readCommStat() & COMMSTAT_NVERROR_MASK) != 0) {
@@ -213,33 +423,78 @@ int MAX17332::writeNVM(const uint8_t* data) {
     // Write 0x0000 to the CommStat register (0x061) 3 times in a row to unlock Write Protection and clear NVError bit
     freeMem();
 
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_COMMSTAT_REG & 0xFF);
-    _wire->write(0x00);         // write LSB
-    _wire->write(0x00);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeRegister(MAX17332_COMMSTAT_REG, 0x0000) != 1) {
       return 0;
     }
 
-    resetFirmware();
+    int ret = resetFirmware();
     protectMem();
 
-    return 1;
+    calibrate();
+    cacheFingerprint(data);
+
+    return ret;
 }
 
 int MAX17332::resetFirmware() {
-    _wire->beginTransmission(_address_l);
-    _wire->write(MAX17332_CONFIG2_REG & 0xFF);
-    _wire->write(0x00);         // write LSB
-    _wire->write(0x80);         // write MSB
-    if (_wire->endTransmission() != 0) {
+    if (writeRegister(MAX17332_CONFIG2_REG, 0x8000) != 1) {
       return 0;
     }
 
     // Wait for POR_CMD bit to be cleared
-    while ((readRegister(MAX17332_CONFIG2_REG) & 0x8000) != 0);
+    return waitCleared(MAX17332_CONFIG2_REG, 0x8000);
+}
 
-    return 1;
+int MAX17332::writeWordAt(uint8_t i2c_address, uint16_t address, uint16_t value) {
+    uint8_t data[2] = {(uint8_t) (value & 0xFF), (uint8_t) (value >> 8)};   // LSB first
+
+    int ret = _transport.write(i2c_address, address & 0xFF, data, sizeof(data));
+    countUsage(true, sizeof(data), ret == 1);
+
+    return ret;
+}
+
+void MAX17332::countUsage(bool write, size_t bytes, bool ok) {
+    if (!_usage) {
+        return;
+    }
+
+    if (!ok && _usage->transactions < 16) {
+        _usage->failed |= 1 << _usage->transactions;
+    }
+    _usage->transactions++;
+    _usage->writes += write ? 1 : 0;
+    _usage->bytes += ok ? bytes : 0;
+}
+
+int MAX17332::waitCleared(uint16_t address, uint16_t mask) {
+    uint32_t start = millis();
+
+    _wait_polls = 0;
+
+    while (true) {
+        int value = readRegister(address);
+        _wait_polls++;
+
+        if (value >= 0 && (value & mask) == 0) {
+            return 1;
+        }
+
+        if (millis() - start >= _wait_timeout) {
+            return MAX17332_TIMEOUT;
+        }
+
+        delay(_wait_poll_interval);
+    }
+}
+
+void MAX17332::setWaitTimeout(uint32_t timeout_ms, uint32_t poll_interval_ms) {
+    _wait_timeout = timeout_ms;
+    _wait_poll_interval = poll_interval_ms;
+}
+
+uint16_t MAX17332::lastWaitPolls() {
+    return _wait_polls;
 }
 
 int MAX17332::resetHardware() {
@@ -257,7 +512,7 @@ uint16_t MAX17332::readDevName()
 {   
     uint16_t dev_name;
 
-    if (!readRegisters(MAX17332_DEVNAME_REG, (uint8_t*) &dev_name, sizeof(dev_name))) {
+    if (readRegisters(MAX17332_DEVNAME_REG, (uint8_t*) &dev_name, sizeof(dev_name)) != 1) {
         return 0;
     }
 
@@ -267,153 +522,295 @@ uint16_t MAX17332::readDevName()
 
 float MAX17332::readVCell()
 {
-    uint16_t v_int;
+    return read<MAX17332_Reg::VCellRep>();
+}
 
-    if (!readRegisters(MAX17332_VCELLREP_REG, (uint8_t*) &v_int, sizeof(v_int))) {
+float MAX17332::readCurrent()
+{
+    uint16_t val;
+
+    if (readRegisters(MAX17332_CURRREP_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0.0;
     }
 
-    return (float) v_int * VOLTAGE_LSB;
-
+    return currentAmps(val);
 }
 
-float MAX17332::readCurrent()
+float MAX17332::readCapacity()
 {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_CURRREP_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_REPCAP_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0.0;
     }
 
-    int16_t curr = static_cast<int16_t>(val);
-
-    return (float) curr * (CURRENT_LSB / RSENSE_DEFAULT);
-
+    return val * ((float) (CAPACITY_LSB * 1e9) / _rsense);
 }
 
 float MAX17332::readRSense()
+{
+    return _rsense * (float) RSENSE_LSB;
+}
+
+int MAX17332::calibrate()
 {
     int value = readRegister(MAX17332_RSENSE_REG);
 
-    if (!value) {
-        return 0.0;
+    if (value <= 0) {
+        setRSense(RSENSE_DEFAULT_UOHM);
+        return 0;
     }
 
-    return (float) value * RSENSE_LSB;
+    setRSense(value);
 
+    return 1;
+}
+
+void MAX17332::setRSense(uint16_t rsense)
+{
+    _rsense = rsense;
+    _capacity_uah = (int32_t) (CAPACITY_LSB * 1e12) / rsense;
+
+    // Largest Q shift keeping |raw| * _current_q within 32 bits (|raw| <= 32768)
+    uint64_t current_uah = (uint64_t) (CURRENT_LSB * 1e12);     // uA per LSB * uOhm
+    _current_shift = 16;
+    while (_current_shift > 0 && ((current_uah << _current_shift) / rsense) >= 65536) {
+        _current_shift--;
+    }
+    _current_q = (int32_t) ((current_uah << _current_shift) / rsense);
 }
 
 float MAX17332::readTemp()
+{
+    return read<MAX17332_Reg::Temp>();
+}
+
+float MAX17332::readSoc()
+{
+    return read<MAX17332_Reg::RepSoc>();
+}
+
+int32_t MAX17332::readVCellMicroVolts()
+{
+    return readInt<MAX17332_Reg::VCellRep>();
+}
+
+int32_t MAX17332::readCurrentMicroAmps()
 {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_TEMP_REG, (uint8_t*) &val, sizeof(val))) {
-        return 0.0;
+    if (readRegisters(MAX17332_CURRREP_REG, (uint8_t*) &val, sizeof(val)) != 1) {
+        return 0;
     }
 
-    int16_t temp = static_cast<int16_t>(val);
+    return currentMicroAmps(val);
+}
 
-    return (float) val * TEMP_LSB;
+MAX17332_Transport::Bus* MAX17332::bus()
+{
+    return _transport.bus();
+}
 
+float MAX17332::currentAmps(uint16_t raw)
+{
+    // Float scale computed here only, so integer-only builds do not link soft-float
+    return static_cast<int16_t>(raw) * ((float) (CURRENT_LSB * 1e6) / _rsense);
 }
 
-float MAX17332::readSoc()
+int32_t MAX17332::currentMicroAmps(uint16_t raw)
+{
+    return ((int32_t) static_cast<int16_t>(raw) * _current_q) >> _current_shift;
+}
+
+int32_t MAX17332::readCapacityMicroAmpHours()
 {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_REPSOC_REG, (uint8_t*) &val, sizeof(val))) {
-        return 0.0;
+    if (readRegisters(MAX17332_REPCAP_REG, (uint8_t*) &val, sizeof(val)) != 1) {
+        return 0;
     }
 
-    int16_t soc = static_cast<int16_t>(val);
+    return (int32_t) val * _capacity_uah;
+}
 
-    return (float) soc * PERC_LSB;
+int32_t MAX17332::readTempMilliCelsius()
+{
+    return readInt<MAX17332_Reg::Temp>();
+}
 
+int32_t MAX17332::readSocMilliPercent()
+{
+    return readInt<MAX17332_Reg::RepSoc>();
 }
 
 bool MAX17332::isCharging() {
 
-    return ((readFProtStat() & FPROTSTAT_ISDIS_MASK) == 0);
+    return ((cachedStatus(MAX17332_CACHE_FPROTSTAT) & FPROTSTAT_ISDIS_MASK) == 0);
 
 }
 
 bool MAX17332::isPermFail() {
 
-    return ((readnBattStatus() & NBATTSTATUS_PERMFAIL_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_NBATTSTATUS) & NBATTSTATUS_PERMFAIL_MASK) != 0);
 
 }
 
 bool MAX17332::hasAlerts() {
 
-    return ((readStatus() & STATUS_ALERT_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_ALERT_MASK) != 0);
 
 }
 
 bool MAX17332::isOverVoltage() {
 
-    return ((readStatus() & STATUS_OVERVOLTAGE_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_OVERVOLTAGE_MASK) != 0);
 
 }
 
 bool MAX17332::isUnderVoltage() {
 
-    return ((readStatus() & STATUS_UNDERVOLTAGE_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_UNDERVOLTAGE_MASK) != 0);
 
 }
 
 bool MAX17332::isOverCurrent() {
 
-    return ((readStatus() & STATUS_OVERCURRENT_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_OVERCURRENT_MASK) != 0);
 
 }
 
 bool MAX17332::isUnderCurrent() {
 
-    return ((readStatus() & STATUS_UNDERCURRENT_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_UNDERCURRENT_MASK) != 0);
 
 }
 
 bool MAX17332::isOverTemperature() {
 
-    return ((readStatus() & STATUS_OVERTEMP_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_OVERTEMP_MASK) != 0);
 
 }
 
 bool MAX17332::isUnderTemperature() {
 
-    return ((readStatus() & STATUS_UNDERTEMP_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_UNDERTEMP_MASK) != 0);
 
 }
 
 bool MAX17332::isOverSOC() {
 
-    return ((readStatus() & STATUS_OVERSOC_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_OVERSOC_MASK) != 0);
 
 }
 
 bool MAX17332::isUnderSOC() {
 
-    return ((readStatus() & STATUS_UNDERSOC_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_UNDERSOC_MASK) != 0);
 
 }
 
 bool MAX17332::isProtectionAlert() {
 
-    return ((readStatus() & STATUS_PROTECTIONALERT_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_PROTECTIONALERT_MASK) != 0);
 
 }
 
 bool MAX17332::isChargingAlert() {
 
-    return ((readStatus() & STATUS_CHARGINGALERT_MASK) != 0);
+    return ((cachedStatus(MAX17332_CACHE_STATUS) & STATUS_CHARGINGALERT_MASK) != 0);
+
+}
+
+int MAX17332::refreshStatus() {
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+    MAX17332_BusUsage usage;
+
+    int ret = poll(_status_plan, words, &usage);
 
+    for (uint8_t i = 0; i < 3; i++) {
+        cacheStatus(i, _status_plan.value(words, cache_registers[i], usage.failed));
+    }
+
+    return ret == 1 ? 1 : 0;
+}
+
+void MAX17332::setStatusMaxAge(uint32_t ms) {
+    _status_max_age = ms;
+}
+
+MAX17332_StatusBits MAX17332::readStatusBits() {
+    MAX17332_StatusBits bits;
+
+    uint16_t words[3];
+
+    if (!statusFresh(MAX17332_CACHE_STATUS) || !statusFresh(MAX17332_CACHE_FPROTSTAT) || !statusFresh(MAX17332_CACHE_NBATTSTATUS)) {
+        refreshStatus();
+    }
+
+    // Straight from the cache: with max age 0 cachedStatus() would read each word again
+    for (uint8_t i = 0; i < 3; i++) {
+        words[i] = (_status_valid & (1 << i)) ? _status_cache[i] : 0xffff;
+    }
+
+    uint16_t val = words[MAX17332_CACHE_STATUS];
+
+    bits.status_reg = val;
+    bits.alerts = (val & STATUS_ALERT_MASK) != 0;
+    bits.over_voltage = (val & STATUS_OVERVOLTAGE_MASK) != 0;
+    bits.under_voltage = (val & STATUS_UNDERVOLTAGE_MASK) != 0;
+    bits.over_current = (val & STATUS_OVERCURRENT_MASK) != 0;
+    bits.under_current = (val & STATUS_UNDERCURRENT_MASK) != 0;
+    bits.over_temperature = (val & STATUS_OVERTEMP_MASK) != 0;
+    bits.under_temperature = (val & STATUS_UNDERTEMP_MASK) != 0;
+    bits.over_soc = (val & STATUS_OVERSOC_MASK) != 0;
+    bits.under_soc = (val & STATUS_UNDERSOC_MASK) != 0;
+    bits.soc_change = (val & STATUS_SOCCHANGE_MASK) != 0;
+    bits.protection_alert = (val & STATUS_PROTECTIONALERT_MASK) != 0;
+    bits.charging_alert = (val & STATUS_CHARGINGALERT_MASK) != 0;
+    bits.charging = (words[MAX17332_CACHE_FPROTSTAT] & FPROTSTAT_ISDIS_MASK) == 0;
+    bits.perm_fail = (words[MAX17332_CACHE_NBATTSTATUS] & NBATTSTATUS_PERMFAIL_MASK) != 0;
+
+    return bits;
+}
+
+bool MAX17332::statusFresh(uint8_t index) {
+    return (_status_valid & (1 << index)) && _status_max_age > 0 && millis() - _status_time[index] <= _status_max_age;
+}
+
+uint16_t MAX17332::cachedStatus(uint8_t index) {
+
+    if (statusFresh(index)) {
+        return _status_cache[index];
+    }
+
+    int value = readRegister(cache_registers[index]);
+    cacheStatus(index, value);
+
+    return value < 0 ? 0xffff : value;
+}
+
+void MAX17332::cacheStatus(uint8_t index, int value) {
+
+    if (value < 0) {
+        _status_valid &= ~(1 << index);
+        return;
+    }
+
+    _status_cache[index] = value;
+    _status_time[index] = millis();
+    _status_valid |= (1 << index);
+
+    // nBattStatus is shadow RAM the firmware rewrites on its own: a change seen here drops the fingerprint
+    if (index == MAX17332_CACHE_NBATTSTATUS && value != _fingerprint_n_batt_status) {
+        _fingerprint_valid = false;
+    }
 }
 
 uint16_t MAX17332::readLocks() {
 
     uint16_t val;
 
-    if (!readRegisters(MAX17332_LOCK_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_LOCK_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
@@ -421,6 +818,51 @@ uint16_t MAX17332::readLocks() {
 
 }
 
+int MAX17332::readRemainingUpdates() {
+    bool fingerprint_valid = _fingerprint_valid;
+
+    int saved = readRegister(MAX17332_NV_UPDATES_REG);
+    if (saved < 0) {
+        return -1;
+    }
+
+    freeMem();
+
+    if (!sendCommand(NV_REMAINING_UPDATES_CMD)) {
+        protectMem();
+        return -1;
+    }
+
+    delay(TRECALL);
+    int ret = waitCleared(MAX17332_COMMSTAT_REG, COMMSTAT_NVBUSY_MASK);
+
+    int raw = ret == 1 ? readRegister(MAX17332_NV_UPDATES_REG) : -1;
+
+    // Put the shadow RAM word back: the cached fingerprint still holds if the restore succeeds
+    if (writeRegister(MAX17332_NV_UPDATES_REG, saved) == 1) {
+        _fingerprint_valid = fingerprint_valid;
+    }
+    protectMem();
+
+    if (ret != 1) {
+        return ret;
+    }
+
+    return raw < 0 ? -1 : decodeRemainingUpdates(raw);
+}
+
+int MAX17332::decodeRemainingUpdates(uint16_t raw) {
+    uint8_t used_bits = (raw | (raw >> 8)) & 0xFF;
+    int used = 0;
+
+    while (used_bits) {
+        used += used_bits & 1;
+        used_bits >>= 1;
+    }
+
+    return used >= NVM_MAX_UPDATES ? 0 : NVM_MAX_UPDATES - used;
+}
+
 int MAX17332::sendCommand(uint16_t cmd) {
 
     return writeRegister(MAX17332_COMMAND_REG, cmd);
@@ -430,26 +872,65 @@ int MAX17332::sendCommand(uint16_t cmd) {
 uint16_t MAX17332::readStatus() {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_STATUS_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_STATUS_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
+    cacheStatus(MAX17332_CACHE_STATUS, val);
+
     return val;
 }
 
 void MAX17332::clearStatus() {
+    MAX17332_WriteSession session(*this);
+
+    session.write(MAX17332_PROT_ALRT_REG, 0x0000);
+    session.write(MAX17332_STATUS_REG, 0b0000000000000000);
+}
+
+int MAX17332::clearStatusBits(uint16_t status_mask, uint16_t prot_alrt_mask, MAX17332_BusUsage* usage) {
+    const uint16_t registers[] = { MAX17332_STATUS_REG, MAX17332_PROT_ALRT_REG };
+    const uint16_t masks[] = { status_mask, prot_alrt_mask };
+    int ret = 1;
+
+    if (usage) {
+        memset(usage, 0, sizeof(*usage));
+    }
 
+    if (!status_mask && !prot_alrt_mask) {
+        return 1;
+    }
+
+    _usage = usage;
     freeMem();
-    writeRegister(MAX17332_PROT_ALRT_REG, 0x0000);
-    writeRegister(MAX17332_STATUS_REG, 0b0000000000000000);
+
+    for (uint8_t i = 0; i < 2 && ret == 1; i++) {
+        if (!masks[i]) {
+            continue;
+        }
+
+        // Read-modify-write, as Maxim's reference drivers clear POR: the other bits are written back
+        // as read. A bit rising between the read and the write is cleared with them
+        int val = readRegister(registers[i]);
+        if (val < 0) {
+            ret = 0;
+        } else if (val & masks[i]) {
+            ret = writeRegister(registers[i], val & ~masks[i]);
+        }
+    }
+
     protectMem();
+    _usage = NULL;
 
+    _status_valid &= ~(1 << MAX17332_CACHE_STATUS);
+
+    return ret;
 }
 
 uint16_t MAX17332::readCommStat() {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_COMMSTAT_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_COMMSTAT_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
@@ -459,20 +940,24 @@ uint16_t MAX17332::readCommStat() {
 uint16_t MAX17332::readFProtStat() {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_FPROTSTAT_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_FPROTSTAT_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
+    cacheStatus(MAX17332_CACHE_FPROTSTAT, val);
+
     return val;
 }
 
 uint16_t MAX17332::readnBattStatus() {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_N_BATT_STATUS_REG, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_N_BATT_STATUS_REG, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
+    cacheStatus(MAX17332_CACHE_NBATTSTATUS, val);
+
     return val;
 }
 
@@ -481,23 +966,17 @@ int MAX17332::writeUserMem1C6(uint16_t value) {
         return 1;
     }
 
-    freeMem();
+    MAX17332_WriteSession session(*this);
 
-    if (!writeRegister(MAX17332_USERMEM_1C6, value)) {
-        return 0;
-    }
-
-    resetFirmware();
-    protectMem();
-
-    return 1;
+    session.write(MAX17332_USERMEM_1C6, value);
 
+    return session.commit();
 }
 
 uint16_t MAX17332::readUserMem1C6() {
     uint16_t val;
 
-    if (!readRegisters(MAX17332_USERMEM_1C6, (uint8_t*) &val, sizeof(val))) {
+    if (readRegisters(MAX17332_USERMEM_1C6, (uint8_t*) &val, sizeof(val)) != 1) {
         return 0xffff;
     }
 
@@ -509,15 +988,151 @@ int MAX17332::shadowMemDump(uint8_t* data) {
     return readRegisters(NVM_START_ADDRESS, data, NVM_SIZE);
 }
 
+int MAX17332::shadowMemDump(Print& out) {
+    MAX17332_FrameWriter frame(out);
+    uint8_t content[NVM_PAGE_SIZE];
+
+    frame.begin(MAX17332_FRAME_BLOCK, NVM_START_ADDRESS, NVM_SIZE);
+
+    for (int page = 0; page < NVM_SIZE / NVM_PAGE_SIZE; page++) {
+        int ret = readRegisters(NVM_START_ADDRESS + page * NVM_PAGE_SIZE / 2, content, NVM_PAGE_SIZE);
+        if (ret != 1) {
+            frame.end();
+            return ret;
+        }
+        frame.write(content, NVM_PAGE_SIZE);
+    }
+
+    return frame.end();
+}
+
+int MAX17332::snapshotDump(Print& out) {
+    MAX17332_FrameWriter frame(out);
+
+    // Failed registers read as 0xffff: no frame rather than a valid CRC over made up values
+    if (snapshot() != 1) {
+        return 0;
+    }
+
+    // Same order as snapshot_registers
+    const int values[] = {
+        status.status_reg, status.f_prot_stat, status.n_batt_status,
+        status.prot_status, status.prot_alrt, status.chg_stat
+    };
+
+    frame.begin(MAX17332_FRAME_REGISTERS, 0, SNAPSHOT_REGISTERS * 4);
+    for (size_t i = 0; i < SNAPSHOT_REGISTERS; i++) {
+        frame.write16(snapshot_registers[i]);
+        frame.write16((uint16_t) values[i]);
+    }
+
+    return frame.end();
+}
+
 int MAX17332::compareWithMem(const uint8_t* data) {
 
-    uint8_t content[NVM_SIZE];
-    if (shadowMemDump(content) < 0) {
+    // Answer from the cached fingerprint when the shadow RAM is known
+    if (_fingerprint_valid) {
+        return MAX17332_fingerprintOf(data) == _fingerprint ? 1 : 0;
+    }
+
+    return compareWithMem(data, NULL, NULL);
+}
+
+int MAX17332::shadowMemFingerprint(uint32_t* fingerprint) {
+
+    uint8_t content[NVM_PAGE_SIZE];
+    uint32_t crc = MAX17332_CRC32_INIT;
+
+    for (int page = 0; page < NVM_SIZE / NVM_PAGE_SIZE; page++) {
+        if (readRegisters(NVM_START_ADDRESS + page * NVM_PAGE_SIZE / 2, content, NVM_PAGE_SIZE) != 1) {
+            return -1;
+        }
+        crc = MAX17332_fingerprintUpdate(crc, page * NVM_PAGE_SIZE, content, NVM_PAGE_SIZE);
+
+        if (NVM_N_BATT_STATUS_OFFSET / NVM_PAGE_SIZE == page) {
+            size_t offset = NVM_N_BATT_STATUS_OFFSET % NVM_PAGE_SIZE;
+            _fingerprint_n_batt_status = content[offset] | (content[offset + 1] << 8);
+        }
+    }
+
+    _fingerprint = ~crc;
+    _fingerprint_valid = true;
+
+    if (fingerprint) {
+        *fingerprint = _fingerprint;
+    }
+
+    return 1;
+}
+
+int MAX17332::compareWithFingerprint(uint32_t fingerprint) {
+
+    if (!_fingerprint_valid && shadowMemFingerprint(NULL) != 1) {
+        return -1;
+    }
+
+    return _fingerprint == fingerprint ? 1 : 0;
+}
+
+void MAX17332::invalidateFingerprint() {
+    _fingerprint_valid = false;
+}
+
+void MAX17332::cacheFingerprint(const uint8_t* data) {
+    _fingerprint = MAX17332_fingerprintOf(data);
+    _fingerprint_n_batt_status = data[NVM_N_BATT_STATUS_OFFSET] | (data[NVM_N_BATT_STATUS_OFFSET + 1] << 8);
+    _fingerprint_valid = true;
+}
+
+int MAX17332::compareWithMem(const uint8_t* data, int16_t* first_diff, uint8_t* page_mask) {
+
+    int ret = 1;
+
+    if (first_diff) {
+        *first_diff = -1;
+    }
+    if (page_mask) {
+        *page_mask = 0;
+    }
+
+    for (int page = 0; page < NVM_SIZE / NVM_PAGE_SIZE; page++) {
+        int16_t diff;
+        int page_ret = comparePage(data, page, &diff);
+
+        if (page_ret < 0) {
+            return -1;
+        }
+
+        if (page_ret == 0) {
+            if (ret == 1 && first_diff) {
+                *first_diff = diff;
+            }
+            ret = 0;
+
+            // Without a mask the first difference is enough
+            if (!page_mask) {
+                return 0;
+            }
+            *page_mask |= (1 << page);
+        }
+    }
+
+    return ret;
+}
+
+int MAX17332::comparePage(const uint8_t* data, int page, int16_t* first_diff) {
+
+    uint8_t content[NVM_PAGE_SIZE];
+
+    if (readRegisters(NVM_START_ADDRESS + page * NVM_PAGE_SIZE / 2, content, NVM_PAGE_SIZE) != 1) {
         return -1;
-    } 
+    }
+
+    for (int j = 0; j < NVM_PAGE_SIZE; j++) {
+        int i = page * NVM_PAGE_SIZE + j;
 
-    for (int i=0; i<NVM_SIZE; i++) {
-        if (i>=120 && i<=127) {     // SKIP ROMID REGISTERS
+        if (i>=NVM_ROMID_OFFSET && i<NVM_ROMID_OFFSET + NVM_ROMID_SIZE) {     // SKIP ROMID REGISTERS
             continue;
         }
 
@@ -525,13 +1140,15 @@ int MAX17332::compareWithMem(const uint8_t* data) {
         //     continue;
         // }
 
-        if (data[i] != content[i]) {
+        if (data[i] != content[j]) {
+            if (first_diff) {
+                *first_diff = i;
+            }
             return 0;
         }
     }
 
     return 1;
-
 }
 
 int MAX17332::writeShadowMem(const uint8_t* data) {
@@ -542,8 +1159,122 @@ int MAX17332::writeShadowMem(const uint8_t* data) {
         return 0;
     }
 
-    resetFirmware();
+    int ret = resetFirmware();
+    protectMem();
+
+    calibrate();
+    cacheFingerprint(data);
+
+    return ret;
+}
+
+bool MAX17332::isUserMem(uint16_t address) {
+    return address == MAX17332_USERMEM_1C6 || address == MAX17332_USERMEM_1E0;
+}
+
+int MAX17332::writeShadowMemDiff(const uint8_t* data, const uint8_t* current, MAX17332_ShadowDiff* diff) {
+    MAX17332_ShadowDiff local;
+    uint8_t page[NVM_PAGE_SIZE];
+    int run_start = -1;         // first word of the pending run
+    int run_end = -1;           // last word of the pending run
+    bool unlocked = false;
+    bool rsense = false;
+    int ret = 1;
+
+    if (!diff) {
+        diff = &local;
+    }
+    memset(diff, 0, sizeof(*diff));
+
+    for (int w = 0; w < NVM_WORDS; w++) {
+        if (!current && (w * 2) % NVM_PAGE_SIZE == 0) {
+            if (readRegisters(NVM_START_ADDRESS + w, page, NVM_PAGE_SIZE) != 1) {
+                ret = 0;
+                break;
+            }
+        }
+
+        if (w >= NVM_ROMID_WORD && w < NVM_ROMID_WORD + NVM_ROMID_WORDS) {     // SKIP ROMID REGISTERS
+            continue;
+        }
+
+        const uint8_t* content = current ? &current[w * 2] : &page[(w * 2) % NVM_PAGE_SIZE];
+        if (content[0] == data[w * 2] && content[1] == data[w * 2 + 1]) {
+            continue;
+        }
+
+        uint16_t address = NVM_START_ADDRESS + w;
+        diff->reset |= !isUserMem(address);
+        rsense |= (address == MAX17332_RSENSE_REG);
+
+        // Extend the pending run over a small gap, never across ROMID
+        if (run_start >= 0 && w - run_end - 1 <= NVM_DIFF_GAP_WORDS && w - run_start < NVM_DIFF_MAX_RUN_WORDS &&
+            !(run_end < NVM_ROMID_WORD && w >= NVM_ROMID_WORD)) {
+            run_end = w;
+            continue;
+        }
+
+        if (run_start >= 0 && writeShadowRun(data, run_start, run_end, unlocked, diff) != 1) {
+            ret = 0;
+            break;
+        }
+
+        run_start = run_end = w;
+    }
+
+    if (ret == 1 && run_start >= 0 && writeShadowRun(data, run_start, run_end, unlocked, diff) != 1) {
+        ret = 0;
+    }
+
+    diff->bytes_saved = NVM_SIZE - diff->bytes_written;
+
+    if (!unlocked) {
+        return ret;
+    }
+
+    if (ret == 1) {
+        if (diff->reset) {
+            ret = resetFirmware();
+        }
+        cacheFingerprint(data);
+    }
     protectMem();
 
+    if (rsense) {
+        calibrate();
+    }
+
+    return ret;
+}
+
+int MAX17332::writeShadowRun(const uint8_t* data, int start, int end, bool& unlocked, MAX17332_ShadowDiff* diff) {
+    uint16_t length = (end - start + 1) * 2;
+
+    if (!unlocked) {
+        freeMem();
+        unlocked = true;
+    }
+
+    if (!writeRegisters(NVM_START_ADDRESS + start, &data[start * 2], length)) {
+        return 0;
+    }
+
+    diff->bytes_written += length;
+    diff->runs++;
+
     return 1;
-}
\ No newline at end of file
+}
+
+#if MAX17332_BUS_STATS
+const MAX17332_BusStats& MAX17332::busStats() {
+    static const MAX17332_BusStats none = MAX17332_BusStats();
+
+    return _stats ? *_stats : none;
+}
+
+void MAX17332::resetBusStats() {
+    if (_stats) {
+        memset(_stats, 0, sizeof(*_stats));
+    }
+}
+#endif
\ No newline at end of file
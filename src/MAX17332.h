@@ -14,7 +14,9 @@
 #define  _MAX17332_H_
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "MAX17332_Transport.h"
+#include "MAX17332_ReadPlan.h"
+#include "MAX17332_BusStats.h"
 
 // I2C ADDRESSES
 #define MAX17332_ADDRESS_L          0x36
@@ -29,6 +31,7 @@
 #define MAX17332_DEVNAME_REG        0x021
 #define MAX17332_TEMP_REG           0x01B
 #define MAX17332_AVSOC_REG          0x00E
+#define MAX17332_REPCAP_REG         0x005
 #define MAX17332_REPSOC_REG         0x006
 #define MAX17332_COMMAND_REG        0x060
 #define MAX17332_COMMSTAT_REG       0x061
@@ -44,23 +47,43 @@
 #define MAX17332_RSENSE_REG         0x19C
 #define MAX17332_USERMEM_1C6        0x1C6
 #define MAX17332_USERMEM_1E0        0x1E0
+#define MAX17332_NV_UPDATES_REG     0x1ED           ///< Shadow RAM word loaded by NV_REMAINING_UPDATES_CMD
 
 // CONSTANTS
 #define MAX17332_DEVICE_NAME        0x4130
 #define NVM_SIZE                    224             ///< bytes
 #define NVM_START_ADDRESS           0x180
+#define NVM_PAGE_SIZE               32              ///< bytes
+#define NVM_ROMID_OFFSET            120             ///< ROMID bytes (read only, skipped by compare and diff)
+#define NVM_ROMID_SIZE              8
+#define NVM_N_BATT_STATUS_OFFSET    ((MAX17332_N_BATT_STATUS_REG - NVM_START_ADDRESS) * 2)     ///< bytes, rewritten by the firmware
+#define NVM_DIFF_GAP_WORDS          1               ///< Unchanged words cheaper to rewrite than a new transaction
+#define NVM_DIFF_MAX_RUN_WORDS      15              ///< Register byte + run fit a 32-byte Wire buffer
 #define TBLOCK                      7500            ///< Block programming time (max is 7360 according to datasheet)
+#define TRECALL                     5               ///< NVM recall time (ms)
+#define NVM_MAX_UPDATES             7               ///< Block copies allowed over the device life
 #define VOLTAGE_LSB                 78.125e-6
 #define CURRENT_LSB                 1.5625e-6
 #define RSENSE_LSB                  1e-3
 #define RSENSE_DEFAULT              10e-3
+#define RSENSE_DEFAULT_UOHM         10000           ///< RSENSE_DEFAULT in nRSense LSBs (1 uOhm)
+#define CAPACITY_LSB                5.0e-6          ///< Vh, divide by RSense for Ah
 #define TEMP_LSB                    0.00390625      ///<  1/256°C
 #define PERC_LSB                    0.00390625      ///<  1/256%
 
+// WAIT DEFAULTS
+#define MAX17332_WAIT_TIMEOUT       1000            ///< ms budget of each status wait
+#define MAX17332_WAIT_POLL_INTERVAL 5               ///< ms between two status polls
+
+// RETURN CODES
+#define MAX17332_TIMEOUT            -3              ///< A wait exceeded its time budget
+#define MAX17332_PENDING            2               ///< A split-phase read has bursts left
+
 // COMMANDS
 #define COPY_NV_BLOCK_CMD           0xE904          ///< Copy shadow RAM to NVM
 #define NV_RECALL_CMD               0xE001          ///< Recall NVM to RAM
 #define HARDWARE_RESET_CMD          0x000F          ///< Recalls nonvolatile memory into RAM and resets the IC hardware
+#define NV_REMAINING_UPDATES_CMD    0xE29B          ///< Recalls the NVM update count into MAX17332_NV_UPDATES_REG
 
 // MASKS
 #define FPROTSTAT_ISDIS_MASK        0b0000000000100000  ///< Charging/Discharging state mask (IsDis bit on FPROTSTAT)
@@ -80,6 +103,9 @@
 #define STATUS_CHARGINGALERT_MASK   0b0000100000000000  ///< Status.CA
 #define STATUS_ALERT_MASK           0b1111111101000100  ///< Status all alerts (OV OC OT OS CA PA UV UC UT US)
 
+// STATUS CACHE
+#define MAX17332_STATUS_MAX_AGE     0               ///< ms. Default max age of cached status words, 0 disables the cache
+
 /**
  * Struct for storing MAX17332 complex status
 */
@@ -94,10 +120,57 @@ typedef struct
 
 } MAX17332_Status;
 
+/**
+ * Struct for reporting the i2c bus usage of a multi-register read or of a call that also writes
+*/
+typedef struct
+{
+    uint16_t transactions;      ///< number of transactions (readRegisters() bursts for a read) issued
+    uint16_t writes;            ///< transactions that were writes (no repeated start)
+    uint16_t bytes;             ///< number of data bytes received or sent
+    uint16_t failed;            ///< mask of failed transactions (bit i = transaction i)
+
+} MAX17332_BusUsage;
+
+/**
+ * Struct for reporting the result of a differential shadow RAM write
+*/
+typedef struct
+{
+    uint16_t bytes_written;     ///< data bytes written
+    uint16_t bytes_saved;       ///< NVM_SIZE - bytes_written
+    uint8_t runs;               ///< writeRegisters() transactions
+    bool reset;                 ///< a firmware reset was needed
+
+} MAX17332_ShadowDiff;
+
+/**
+ * Struct for storing the decoded STATUS, FPROTSTAT and N_BATT_STATUS flags
+*/
+typedef struct
+{
+    uint16_t status_reg;
+    bool alerts : 1;                ///< any bit of STATUS_ALERT_MASK
+    bool over_voltage : 1;
+    bool under_voltage : 1;
+    bool over_current : 1;
+    bool under_current : 1;
+    bool over_temperature : 1;
+    bool under_temperature : 1;
+    bool over_soc : 1;
+    bool under_soc : 1;
+    bool soc_change : 1;
+    bool protection_alert : 1;
+    bool charging_alert : 1;
+    bool charging : 1;              ///< FPROTSTAT.IsDis cleared
+    bool perm_fail : 1;             ///< N_BATT_STATUS permanent failure
+
+} MAX17332_StatusBits;
+
 
 class MAX17332 {
     public:
-        MAX17332(TwoWire& wire, uint16_t address_l=MAX17332_ADDRESS_L, uint16_t address_h=MAX17332_ADDRESS_H);
+        MAX17332(MAX17332_Transport::Bus& bus, uint16_t address_l=MAX17332_ADDRESS_L, uint16_t address_h=MAX17332_ADDRESS_H);
         ~MAX17332();
 
         /**
@@ -116,6 +189,75 @@ class MAX17332 {
         */
         void update();
 
+        /**
+            @brief  MAX17332 status update using burst reads. Fields of a failed burst are set to -1
+            @param  usage optional output for the number of transactions and bytes used
+            @return 1 if OK; 0 if any burst failed
+        */
+        int snapshot(MAX17332_BusUsage* usage = NULL);
+
+        /**
+            @brief  Executes a read plan. Words of a failed burst are set to 0xffff
+            @param  plan built MAX17332_ReadPlan
+            @param  buffer uint16_t output array. Must be of size plan.words()
+            @param  usage optional output for the number of transactions, bytes and failed bursts
+            @return 1 if OK; 0 if any burst failed; -1 if the plan is not built
+        */
+        int poll(const MAX17332_ReadPlan& plan, uint16_t* buffer, MAX17332_BusUsage* usage = NULL);
+
+        /**
+            @brief  Starts a split-phase poll() of plan. Call pollRead() until it stops returning MAX17332_PENDING.
+                    plan and buffer must stay valid until then
+            @param  plan built MAX17332_ReadPlan
+            @param  buffer uint16_t output array. Must be of size plan.words()
+            @return 1 if OK; 0 if a split-phase read is already pending; -1 if the plan is not built
+        */
+        int startRead(const MAX17332_ReadPlan& plan, uint16_t* buffer);
+
+        /**
+            @brief  Advances the split-phase read: collects the burst in flight and issues at most one more.
+                    Where the transport has no async transfers each call blocks for one burst
+            @return MAX17332_PENDING while bursts are left; then as poll(); -1 if no read was started
+        */
+        int pollRead();
+
+        /**
+            @brief  Returns the outcome of the split-phase read without touching the bus
+            @param  usage optional output for the number of transactions, bytes and failed bursts so far
+            @return as pollRead()
+        */
+        int readResult(MAX17332_BusUsage* usage = NULL);
+
+        /**
+            @brief  Reads and decodes a register of the MAX17332_Reg table. Bank and scaling are resolved at compile time
+            @return decoded value or the register error value (0.0 or 0xffff)
+        */
+        template <typename R>
+        typename R::type read() {
+            uint16_t raw;
+
+            if (readRegistersAt(R::high_bank ? _address_h : _address_l, R::address, (uint8_t*) &raw, sizeof(raw)) != 1) {
+                return R::error();
+            }
+
+            return R::decode(raw);
+        }
+
+        /**
+            @brief  Reads a register of the MAX17332_Reg table in integer units. No float math
+            @return integer value or 0 on transmission error
+        */
+        template <typename R>
+        int32_t readInt() {
+            uint16_t raw;
+
+            if (readRegistersAt(R::high_bank ? _address_h : _address_l, R::address, (uint8_t*) &raw, sizeof(raw)) != 1) {
+                return 0;
+            }
+
+            return R::decodeInt(raw);
+        }
+
         /**
             @brief  Returns the 2-bytes device name (0x4130)
         */
@@ -127,7 +269,14 @@ class MAX17332 {
         float readVCell();
 
         /**
-            @brief  Returns the RSense value (mOhms)
+            @brief  Reads nRSense once and precomputes the integer current and capacity scale factors.
+                    Called by begin() and after the shadow RAM is rewritten by this driver
+            @return 1 if OK; 0 on transmission error or unset nRSense (RSENSE_DEFAULT is used)
+        */
+        int calibrate();
+
+        /**
+            @brief  Returns the RSense value read by calibrate() (mOhms)
         */
         float readRSense();
         
@@ -135,6 +284,11 @@ class MAX17332 {
             @brief  Returns the battery avg current from CURRREP_REG (Amps)
         */
         float readCurrent();
+
+        /**
+            @brief  Returns the reported remaining capacity from REPCAP_REG (mAh)
+        */
+        float readCapacity();
         
         /**
             @brief  Returns the (thermistor or die) Temp (°C)
@@ -147,74 +301,155 @@ class MAX17332 {
         float readSoc();
         
         /**
-            @brief  Uses readnBattStatus. Returns true if battry is in permanent fail status.
+            @brief  Returns the cell avg voltage from VCELLREP_REG (microvolts)
+        */
+        int32_t readVCellMicroVolts();
+
+        /**
+            @brief  Returns the battery avg current from CURRREP_REG (microamps)
+        */
+        int32_t readCurrentMicroAmps();
+
+        /**
+            @brief  Returns the bus the gauge is on
+        */
+        MAX17332_Transport::Bus* bus();
+
+        /**
+            @brief  Converts a raw CURR/CURRREP word to microamps with the calibrated RSense
+        */
+        int32_t currentMicroAmps(uint16_t raw);
+
+        /**
+            @brief  Converts a raw CURR/CURRREP word to amps with the calibrated RSense
+        */
+        float currentAmps(uint16_t raw);
+
+        /**
+            @brief  Returns the reported remaining capacity from REPCAP_REG (microamp hours)
+        */
+        int32_t readCapacityMicroAmpHours();
+
+        /**
+            @brief  Returns the (thermistor or die) Temp (milli °C)
+        */
+        int32_t readTempMilliCelsius();
+
+        /**
+            @brief  Returns the battery State Of Charge from REPSOC_REG (milli %)
+        */
+        int32_t readSocMilliPercent();
+
+        /*
+            Status predicates. The status cache is opt-in: with the default max age
+            (MAX17332_STATUS_MAX_AGE, 0) every predicate reads its register on each call.
+            Call setStatusMaxAge() to answer from words read within that many ms, and
+            refreshStatus() or snapshot() to fill the cache with one plan poll.
+        */
+
+        /**
+            @brief  Uses the cached N_BATT_STATUS_REG (see setStatusMaxAge()). Returns true if battry is in permanent fail status.
         */
         bool isPermFail();
 
         /**
-            @brief  Uses readFProtStat. Returns true if battry is charging false if discharging.
+            @brief  Uses the cached FPROTSTAT_REG (see setStatusMaxAge()). Returns true if battry is charging false if discharging.
         */
         bool isCharging();
 
         /**
-            @brief  Uses readStatus. Returns true if battry status reg 0x000 has any alert bit set.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry status reg 0x000 has any alert bit set.
         */
         bool hasAlerts();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in OV Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in OV Alert.
         */
         bool isOverVoltage();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in UV Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in UV Alert.
         */
         bool isUnderVoltage();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in OC Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in OC Alert.
         */
         bool isOverCurrent();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in UC Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in UC Alert.
         */
         bool isUnderCurrent();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in OT Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in OT Alert.
         */
         bool isOverTemperature();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in UT Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in UT Alert.
         */
         bool isUnderTemperature();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in OS Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in OS Alert.
         */
         bool isOverSOC();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in US Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in US Alert.
         */
         bool isUnderSOC();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in PA Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in PA Alert.
         */
         bool isProtectionAlert();
 
         /**
-            @brief  Uses readStatus. Returns true if battry is in CA Alert.
+            @brief  Uses the cached STATUS_REG (see setStatusMaxAge()). Returns true if battry is in CA Alert.
         */
         bool isChargingAlert();
 
+        /**
+            @brief  Reads STATUS_REG, FPROTSTAT_REG and N_BATT_STATUS_REG into the status cache with one plan poll
+            @return 1 if OK; 0 on transmission error
+        */
+        int refreshStatus();
+
+        /**
+            @brief  Sets how long cached status words are used by the is*() predicates before
+                    they are read again. 0 disables the cache (every predicate reads the bus), which is the
+                    default (MAX17332_STATUS_MAX_AGE)
+            @param  ms max age in milliseconds
+        */
+        void setStatusMaxAge(uint32_t ms);
+
+        /**
+            @brief  Returns the decoded status flags. Uses the status cache, refreshing all three words with one
+                    plan poll if any is stale
+        */
+        MAX17332_StatusBits readStatusBits();
+
         /**
             @brief  Reads the status of permanent locks in the LOCK_REG
         */
         uint16_t readLocks();
+
+        /**
+            @brief  Queries the number of NVM block copies left (NV_REMAINING_UPDATES_CMD). The shadow RAM word it
+                    overwrites is restored
+            @return 0 - NVM_MAX_UPDATES; -1 on transmission error; MAX17332_TIMEOUT if NVBusy did not clear in time
+        */
+        int readRemainingUpdates();
+
+        /**
+            @brief  Decodes MAX17332_NV_UPDATES_REG after NV_REMAINING_UPDATES_CMD: each used update sets one bit,
+                    mirrored in both bytes
+            @return 0 - NVM_MAX_UPDATES
+        */
+        static int decodeRemainingUpdates(uint16_t raw);
         
         /**
             @brief  Sends a command to COMMAND_REG
@@ -236,6 +471,15 @@ class MAX17332 {
         */
         void clearStatus();
 
+        /**
+            @brief  Clears only the given STATUS_REG and PROT_ALRT_REG bits (read-modify-write)
+            @param  status_mask STATUS_REG bits to clear
+            @param  prot_alrt_mask PROT_ALRT_REG bits to clear
+            @param  usage optional output, bus usage of the unlock, read-modify-writes and relock
+            @return 1 if OK; 0 on transmission error
+        */
+        int clearStatusBits(uint16_t status_mask, uint16_t prot_alrt_mask = 0, MAX17332_BusUsage* usage = NULL);
+
         /**
             @brief  Reads the FPROTSTAT_REG
         */
@@ -248,6 +492,7 @@ class MAX17332 {
 
         /**
             @brief  Writes value to the UserMem1C6 REG (0x1C6) (shadow RAM)
+            @return 1 if OK; 0 on transmission error. User memory needs no firmware reset
         */
         int writeUserMem1C6(uint16_t value);
 
@@ -264,24 +509,115 @@ class MAX17332 {
         int shadowMemDump(uint8_t* data);
 
         /**
-            @brief  Compares input array with Shadow RAM content
+            @brief  Streams the shadow RAM as a MAX17332_FRAME_BLOCK binary frame, one page at a time
+            @param  out destination, e.g. Serial
+            @return 1 if OK; -1 on transmission error; 0 if bytes received are less than length or out refused bytes.
+                    A frame cut short by an error fails its CRC
+        */
+        int shadowMemDump(Print& out);
+
+        /**
+            @brief  Takes a snapshot() and writes its registers as a MAX17332_FRAME_REGISTERS binary frame.
+                    Nothing is written if the snapshot fails
+            @param  out destination, e.g. Serial
+            @return 1 if OK; 0 on transmission or output error
+        */
+        int snapshotDump(Print& out);
+
+        /**
+            @brief  Compares input array with Shadow RAM content. Reads one page (NVM_PAGE_SIZE) at a time
+                    and stops at the first difference, or answers from the cached fingerprint without a read
+                    (see shadowMemFingerprint()). The cached answer can be stale
             @param  data uint8_t output data array. Must be of size NVM_SIZE
             @return 1 if content is equal to input; 0 if they differ; -1 on error
         */
         int compareWithMem(const uint8_t* data);
 
+        /**
+            @brief  Compares input array with Shadow RAM content one page (NVM_PAGE_SIZE) at a time
+            @param  data uint8_t output data array. Must be of size NVM_SIZE
+            @param  first_diff optional output for the offset of the first differing byte, -1 if none
+            @param  page_mask optional output for the mask of differing pages (bit i = page i).
+                    If NULL the compare stops at the first difference, otherwise all pages are read
+            @return 1 if content is equal to input; 0 if they differ; -1 on error
+        */
+        int compareWithMem(const uint8_t* data, int16_t* first_diff, uint8_t* page_mask);
+
+        /**
+            @brief  Computes the shadow RAM fingerprint (CRC-32, ROMID excluded) one page at a time and caches it.
+                    The cache is kept until the shadow RAM is written, a command is sent or a status read
+                    (snapshot(), the status cache) sees nBattStatus differ, and lets compareWithMem(data)
+                    answer without reading the memory. Other changes by the firmware or another bus master go
+                    unnoticed: call invalidateFingerprint() or compareWithMem(data, NULL, NULL) to read
+            @param  fingerprint optional output
+            @return 1 if OK; -1 on transmission error
+        */
+        int shadowMemFingerprint(uint32_t* fingerprint);
+
+        /**
+            @brief  Compares the shadow RAM fingerprint with a known one, e.g. MAX17332_fingerprint(golden) computed at compile time.
+                    Uses the cached fingerprint if valid
+            @return 1 if equal; 0 if they differ; -1 on error
+        */
+        int compareWithFingerprint(uint32_t fingerprint);
+
+        /**
+            @brief  Drops the cached fingerprint, e.g. if another bus master may have changed the shadow RAM
+        */
+        void invalidateFingerprint();
+
         /**
             @brief  Writes data to the shadow RAM (0x180 - 0x1EF). Data is NOT flashed on the NVM
             @param  data const uint8_t input data array. Must be of size NVM_SIZE
-            @return 1 if OK; -1 on transmission error; 0 if bytes received are less than length
+            @return 1 if OK; 0 on transmission error; MAX17332_TIMEOUT if the firmware reset did not complete
         */
         int writeShadowMem(const uint8_t* data);
 
+        /**
+            @brief  Writes only the words of data that differ from the shadow RAM, skipping ROMID.
+                    The firmware reset is skipped when only user memory words changed
+            @param  data const uint8_t input data array. Must be of size NVM_SIZE
+            @param  current optional known shadow RAM content (NVM_SIZE). If NULL it is read page by page
+            @param  diff optional output for the bytes written/saved, runs and reset
+            @return 1 if OK; 0 on transmission error; MAX17332_TIMEOUT if the firmware reset did not complete
+        */
+        int writeShadowMemDiff(const uint8_t* data, const uint8_t* current = NULL, MAX17332_ShadowDiff* diff = NULL);
+
+        /**
+            @brief  Sets the time budget of the blocking waits (firmware reset, NVBusy)
+            @param  timeout_ms max time spent polling
+            @param  poll_interval_ms time between two polls
+        */
+        void setWaitTimeout(uint32_t timeout_ms, uint32_t poll_interval_ms = MAX17332_WAIT_POLL_INTERVAL);
+
+        /**
+            @brief  Returns the number of register polls done by the last wait
+        */
+        uint16_t lastWaitPolls();
+
+#if MAX17332_BUS_STATS
+        /**
+            @brief  Returns the bus statistics collected since the last reset. All zero for objects
+                    beyond MAX17332_BUS_STATS_INSTANCES
+        */
+        const MAX17332_BusStats& busStats();
+
+        /**
+            @brief  Clears the bus statistics
+        */
+        void resetBusStats();
+#endif
+
         /**
             This declares MAX17332_Programmer as a friend class
         */
         friend class MAX17332_Programmer;
 
+        /**
+            This declares MAX17332_WriteSession as a friend class
+        */
+        friend class MAX17332_WriteSession;
+
     private:
         /**
             @brief  Returns the right i2c slave address (H/L) according to location of reg_address
@@ -305,22 +641,76 @@ class MAX17332 {
         /**
             @brief  Flashes data to the NVM (0x180 - 0x1EF). NVM is limited to seven writes maximum. Use at own risk. Verification is not implemented
             @param  data const uint8_t input data array. Must be of size NVM_SIZE
-            @return 2 if already written; 1 if OK; 0 on transmission error; -1 on NVError; -2 on verification error
+            @return 2 if already written; 1 if OK; 0 on transmission error; -1 on NVError; -2 on verification error;
+                    MAX17332_TIMEOUT if NVBusy or the firmware reset did not clear in time
         */
         int writeNVM(const uint8_t* data);
 
+        /**
+            @brief  writeNVM() without the initial comparison, for callers that already compared
+            @return see writeNVM(), except 2
+        */
+        int copyNVM(const uint8_t* data);
+
         /**
             @brief  Initiates POR sequence and waits for completion (CONFIG2_REG POR_CMD bit)
-            @return 1 if OK; 0 on transmission error
+            @return 1 if OK; 0 on transmission error; MAX17332_TIMEOUT if POR_CMD did not clear in time
         */
         int resetFirmware();
 
+        /**
+            @brief  Polls a register until the mask bits are cleared or the wait budget expires.
+                    Failed reads count as polls and keep waiting
+            @param  address 9-bit address
+            @param  mask bits to wait for
+            @return 1 if cleared; MAX17332_TIMEOUT if the budget expired
+        */
+        int waitCleared(uint16_t address, uint16_t mask);
+
         /**
             @brief  Write 0x000F to the Command register 0x060 to POR the IC
             @return 1 if OK; 0 on transmission error
         */
         int resetHardware();
 
+        /**
+            @brief  Stores rsense and precomputes the integer current and capacity scale factors. The float
+                    accessors derive their scales from _rsense, so no float math runs here
+            @param  rsense nRSense value (uOhm)
+        */
+        void setRSense(uint16_t rsense);
+
+        /**
+            @brief  Caches the fingerprint of data, known to match the shadow RAM
+        */
+        void cacheFingerprint(const uint8_t* data);
+
+        /**
+            @brief  Compares one shadow RAM page (NVM_PAGE_SIZE bytes, ROMID skipped) with the same page of data
+            @param  data NVM_SIZE input data array
+            @param  page page index
+            @param  first_diff optional output for the offset in data of the first differing byte
+            @return 1 if equal; 0 if they differ; -1 on transmission error
+        */
+        int comparePage(const uint8_t* data, int page, int16_t* first_diff = NULL);
+
+        /**
+            @brief  Returns a status cache word, reading it if stale
+            @param  index MAX17332_CACHE_STATUS, MAX17332_CACHE_FPROTSTAT or MAX17332_CACHE_NBATTSTATUS
+            @return register content or 0xffff on transmission error
+        */
+        uint16_t cachedStatus(uint8_t index);
+
+        /**
+            @brief  Returns true if a status cache word is valid and younger than the max age
+        */
+        bool statusFresh(uint8_t index);
+
+        /**
+            @brief  Stores a freshly read status word in the cache
+        */
+        void cacheStatus(uint8_t index, int value);
+
         /**
             @brief  Reads register @address
             @param  address 9-bit address
@@ -337,6 +727,16 @@ class MAX17332 {
         */
         int readRegisters(uint16_t address, uint8_t* data, size_t length);
 
+        /**
+            @brief  Reads length bytes starting from address using the given i2c slave address
+            @param  i2c_address i2c slave address of the bank
+            @param  address 9-bit address
+            @param  data uint8_t output data array
+            @param  length size of data (bytes) to read
+            @return 1 if OK; -1 on transmission error; 0 if bytes received are less than length
+        */
+        int readRegistersAt(uint8_t i2c_address, uint16_t address, uint8_t* data, size_t length);
+
         /**
             @brief  Writes register @address. For some registers mem should be freed in advance
             @param  address 9-bit address
@@ -354,13 +754,65 @@ class MAX17332 {
         */
         int writeRegisters(uint16_t address, const uint8_t* data, const uint32_t length);
 
+        /**
+            @brief  Writes a word (LSB first) to address on the given i2c slave address. No bus stats, no fingerprint invalidation
+            @return 1 if OK; 0 on transmission error
+        */
+        int writeWordAt(uint8_t i2c_address, uint16_t address, uint16_t value);
+
+        /**
+            @brief  Adds a transaction to _usage, if set
+        */
+        void countUsage(bool write, size_t bytes, bool ok);
+
+        /**
+            @brief  Writes shadow RAM words start..end from data, unlocking memory on the first call
+            @param  data NVM_SIZE input data array
+            @param  start first word index
+            @param  end last word index
+            @param  unlocked set once memory has been unlocked
+            @param  diff counters to update
+            @return 1 if OK; 0 on transmission error
+        */
+        int writeShadowRun(const uint8_t* data, int start, int end, bool& unlocked, MAX17332_ShadowDiff* diff);
+
+        /**
+            @brief  Returns true for shadow RAM words that do not affect the fuel gauge model (no firmware reset needed)
+        */
+        static bool isUserMem(uint16_t address);
+
     public:
         MAX17332_Status status;
 
     private:
         uint16_t _address_l;    ///< i2c address for low mem block
         uint16_t _address_h;    ///< i2c address for high mem block (shadow RAM)
-        TwoWire* _wire;         ///< Pointer to i2c interface
+        MAX17332_Transport _transport;      ///< i2c interface (see MAX17332_Transport.h)
+        MAX17332_ReadPlan _snapshot_plan;   ///< Burst plan used by snapshot()
+        MAX17332_ReadPlan _status_plan;     ///< Burst plan used by refreshStatus()
+        const MAX17332_ReadPlan* _read_plan;    ///< split-phase read, NULL if none started
+        uint16_t* _read_buffer;
+        uint8_t _read_burst;                ///< next burst to issue
+        bool _read_in_flight;               ///< burst _read_burst - 1 awaits its result
+        int _read_ret;
+        MAX17332_BusUsage _read_usage;
+        MAX17332_BusUsage* _usage;          ///< counts every transaction of the running call, NULL if none
+        uint32_t _read_start;               ///< micros() when the burst in flight was issued
+        uint16_t _status_cache[3];          ///< STATUS, FPROTSTAT, N_BATT_STATUS
+        uint32_t _status_time[3];           ///< millis() of each read
+        uint8_t _status_valid;              ///< mask of valid cache words
+        uint32_t _status_max_age;
+        uint16_t _rsense;                   ///< nRSense (uOhm). Float scales are derived in the float accessors
+        int32_t _current_q;                 ///< uA per CURRREP LSB << _current_shift
+        uint8_t _current_shift;
+        int32_t _capacity_uah;              ///< uAh per REPCAP LSB
+        uint32_t _wait_timeout;
+        uint32_t _wait_poll_interval;
+        uint16_t _wait_polls;               ///< polls done by the last wait
+        uint32_t _fingerprint;              ///< cached shadow RAM fingerprint
+        uint16_t _fingerprint_n_batt_status;    ///< nBattStatus covered by _fingerprint
+        bool _fingerprint_valid;
+        MAX17332_BusStats* _stats;          ///< slot of the MAX17332_BUS_STATS pool, NULL if none
 
 };
 
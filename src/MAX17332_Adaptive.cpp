@@ -0,0 +1,204 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Adaptive.h"
+#include "MAX17332_Registers.h"
+
+static const uint16_t adaptive_registers[] = {
+    MAX17332_STATUS_REG,
+    MAX17332_REPSOC_REG,
+    MAX17332_VCELLREP_REG,
+    MAX17332_CURRREP_REG,
+    MAX17332_FPROTSTAT_REG,
+};
+
+MAX17332_AdaptivePoller::MAX17332_AdaptivePoller(MAX17332& gauge, uint32_t min_interval_ms, uint32_t max_interval_ms):
+    _gauge(&gauge), _plan(adaptive_registers, sizeof(adaptive_registers) / sizeof(adaptive_registers[0])),
+    _min(MAX17332_ADAPTIVE_MIN_INTERVAL), _max(MAX17332_ADAPTIVE_MAX_INTERVAL), _threshold(MAX17332_ADAPTIVE_CURRENT),
+    _frequency(MAX17332_ADAPTIVE_BUS_CLOCK) {
+    memset(_words, 0xff, sizeof(_words));
+    _failed = 0xFFFF;
+    _interval = _min;
+    setBounds(min_interval_ms, max_interval_ms);
+    begin();
+}
+
+void MAX17332_AdaptivePoller::begin() {
+    _interval = _min;
+    _start = millis();
+    _last = _start;
+    _due = true;
+    _triggers = 0;
+    _current = 0;
+    _charging = false;
+    _soc_time = 0;
+    _soc_gap = 0;
+    _poll_us = 0;
+    memset(&_report, 0, sizeof(_report));
+}
+
+int MAX17332_AdaptivePoller::service() {
+    uint32_t now = millis();
+
+    if (!_due && now - _last < _interval) {
+        return 2;
+    }
+
+    // Before the bus access: a wake() from an ISR during the transfer makes the next call poll
+    _due = false;
+
+    MAX17332_BusUsage usage;
+    int ret = _gauge->poll(_plan, _words, &usage);
+
+    uint32_t poll_us = busTime(usage);
+    _poll_us += poll_us;
+    _report.bus_us += poll_us;
+    _report.polls++;
+    _failed = usage.failed;
+    _last = now;
+
+    if (ret != 1) {
+        return 0;
+    }
+
+    _triggers = 0;
+
+    int32_t current = currentMicroAmps();
+    bool charging = this->charging();
+
+    if (charging) {
+        // A steady charge is no transient: only its start and current steps keep the fast rate
+        int32_t step = current - _current;
+        if (!_charging) {
+            _triggers |= MAX17332_ADAPTIVE_TRIGGER_CHARGING;
+            _soc_time = now;
+            _soc_gap = 0;
+        }
+        if (step >= _threshold || step <= -_threshold) {
+            _triggers |= MAX17332_ADAPTIVE_TRIGGER_CURRENT;
+        }
+    } else if (current >= _threshold || current <= -_threshold) {
+        _triggers |= MAX17332_ADAPTIVE_TRIGGER_CURRENT;
+    }
+
+    bool soc_step = _plan.value(_words, MAX17332_STATUS_REG, _failed) & STATUS_SOCCHANGE_MASK;
+    if (soc_step) {
+        if (!charging) {
+            _triggers |= MAX17332_ADAPTIVE_TRIGGER_SOCCHANGE;
+        } else if (!(_triggers & MAX17332_ADAPTIVE_TRIGGER_CHARGING)) {
+            _soc_gap = now - _soc_time;
+        }
+        _soc_time = now;
+
+        // Latched: clear it so the next change shows
+        MAX17332_BusUsage clear;
+        if (_gauge->clearStatusBits(STATUS_SOCCHANGE_MASK, 0, &clear) == 1) {
+            _report.soc_clears++;
+        }
+        _report.bus_us += busTime(clear);
+    }
+
+    if (_triggers) {
+        _interval = _min;
+    } else {
+        _interval = (_interval > _max / 2) ? _max : _interval * 2;
+    }
+
+    // A steady charge is polled at least twice per SOC step so no step goes unseen
+    if (charging && _soc_gap && _interval > _soc_gap / 2) {
+        _interval = (_soc_gap / 2 < _min) ? _min : _soc_gap / 2;
+    }
+
+    _current = current;
+    _charging = charging;
+
+    return 1;
+}
+
+void MAX17332_AdaptivePoller::wake() {
+    _due = true;
+}
+
+int MAX17332_AdaptivePoller::setBounds(uint32_t min_interval_ms, uint32_t max_interval_ms) {
+
+    // The interval doubles from min and report() divides by it
+    if (min_interval_ms == 0 || min_interval_ms > max_interval_ms) {
+        return 0;
+    }
+
+    _min = min_interval_ms;
+    _max = max_interval_ms;
+
+    if (_interval < _min) {
+        _interval = _min;
+    } else if (_interval > _max) {
+        _interval = _max;
+    }
+
+    return 1;
+}
+
+void MAX17332_AdaptivePoller::setCurrentThreshold(int32_t current_ua) {
+    _threshold = current_ua;
+}
+
+void MAX17332_AdaptivePoller::setBusClock(uint32_t frequency) {
+    _frequency = frequency;
+}
+
+uint32_t MAX17332_AdaptivePoller::interval() {
+    return _interval;
+}
+
+uint8_t MAX17332_AdaptivePoller::triggers() {
+    return _triggers;
+}
+
+float MAX17332_AdaptivePoller::vcell() {
+    return _plan.get<MAX17332_Reg::VCellRep>(_words, _failed);
+}
+
+int32_t MAX17332_AdaptivePoller::currentMicroAmps() {
+    int raw = _plan.value(_words, MAX17332_CURRREP_REG, _failed);
+
+    return raw < 0 ? 0 : _gauge->currentMicroAmps(raw);
+}
+
+float MAX17332_AdaptivePoller::soc() {
+    return _plan.get<MAX17332_Reg::RepSoc>(_words, _failed);
+}
+
+bool MAX17332_AdaptivePoller::charging() {
+    int fprotstat = _plan.value(_words, MAX17332_FPROTSTAT_REG, _failed);
+
+    return fprotstat >= 0 && (fprotstat & FPROTSTAT_ISDIS_MASK) == 0;
+}
+
+MAX17332_AdaptiveReport MAX17332_AdaptivePoller::report() {
+    MAX17332_AdaptiveReport report = _report;
+
+    report.fixed_polls = (millis() - _start) / _min + 1;
+    if (report.polls && report.fixed_polls > report.polls) {
+        // dSOCi clears would be the same at a fixed rate: only the poll cost is saved
+        report.saved_us = (uint32_t) ((uint64_t) (report.fixed_polls - report.polls) * _poll_us / report.polls);
+    }
+
+    return report;
+}
+
+uint32_t MAX17332_AdaptivePoller::busTime(const MAX17332_BusUsage& usage) {
+    // Per transaction: address and register byte, for reads the address again after a repeated start
+    uint32_t bytes = usage.transactions * 3 - usage.writes + usage.bytes;
+
+    // 9 clocks per byte with the ACK, about 4 for start, repeated start and stop
+    return (uint32_t) (((uint64_t) bytes * 9 + usage.transactions * 4) * 1000000 / _frequency);
+}
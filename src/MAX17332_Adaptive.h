@@ -0,0 +1,139 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_ADAPTIVE_H_
+#define  _MAX17332_ADAPTIVE_H_
+
+#include "MAX17332.h"
+
+// ADAPTIVE POLLING DEFAULTS
+#define MAX17332_ADAPTIVE_MIN_INTERVAL      500             ///< ms, during transients
+#define MAX17332_ADAPTIVE_MAX_INTERVAL      60000           ///< ms, idle pack
+#define MAX17332_ADAPTIVE_CURRENT           10000           ///< uA, |current| (while charging: current step) at or above keeps the fast rate
+#define MAX17332_ADAPTIVE_BUS_CLOCK         100000          ///< Hz, for the bus time report
+
+// REASONS FOR THE FAST RATE
+#define MAX17332_ADAPTIVE_TRIGGER_CURRENT   0b001           ///< |CURRREP| at or above the threshold; while charging, a CURRREP step that large
+#define MAX17332_ADAPTIVE_TRIGGER_CHARGING  0b010           ///< charge started (FPROTSTAT.IsDis cleared)
+#define MAX17332_ADAPTIVE_TRIGGER_SOCCHANGE 0b100           ///< STATUS.dSOCi set while not charging (cleared by the poller)
+
+/**
+ * Struct reporting the bus time of adaptive polling against polling at the min interval
+*/
+typedef struct
+{
+    uint32_t polls;             ///< polls done
+    uint32_t fixed_polls;       ///< polls a fixed min interval schedule would have done
+    uint32_t bus_us;            ///< modelled bus time of the polls and dSOCi clears done
+    uint32_t saved_us;          ///< modelled bus time of the polls avoided
+    uint32_t soc_clears;        ///< dSOCi clears
+
+} MAX17332_AdaptiveReport;
+
+/**
+ * Polls VCELLREP, CURRREP, REPSOC, STATUS and FPROTSTAT at a rate following the pack activity.
+ * A poll seeing |current| at or above the threshold or dSOCi drops the interval to the min; a
+ * quiet poll doubles it up to the max. While charging only the charge start and current steps
+ * of at least the threshold drop it to the min: a steady charge backs off like an idle pack, up
+ * to half the time between the last two dSOCi so every SOC step is seen
+*/
+class MAX17332_AdaptivePoller {
+
+    public:
+        /**
+            @brief  Bounds as in setBounds(); invalid ones fall back to the defaults
+        */
+        MAX17332_AdaptivePoller(MAX17332& gauge, uint32_t min_interval_ms = MAX17332_ADAPTIVE_MIN_INTERVAL,
+            uint32_t max_interval_ms = MAX17332_ADAPTIVE_MAX_INTERVAL);
+
+        /**
+            @brief  Starts at the min interval with a poll due now and clears the report
+        */
+        void begin();
+
+        /**
+            @brief  Polls the gauge if the interval has elapsed
+            @return 1 if polled; 0 on transmission error (interval kept); 2 if nothing was due
+        */
+        int service();
+
+        /**
+            @brief  Makes the next service() poll, e.g. from an ALRT handler. ISR safe
+        */
+        void wake();
+
+        /**
+            @brief  Sets the interval bounds (ms)
+            @return 1 if OK; 0 if min is 0 or exceeds max (bounds kept)
+        */
+        int setBounds(uint32_t min_interval_ms, uint32_t max_interval_ms);
+
+        /**
+            @brief  Sets the |current|, or while charging the current step, keeping the fast rate (uA)
+        */
+        void setCurrentThreshold(int32_t current_ua);
+
+        /**
+            @brief  Sets the i2c clock used to model the bus time in the report (Hz)
+        */
+        void setBusClock(uint32_t frequency);
+
+        /**
+            @brief  Returns the current interval (ms)
+        */
+        uint32_t interval();
+
+        /**
+            @brief  Returns the MAX17332_ADAPTIVE_TRIGGER_ bits seen by the last poll, 0 if quiet
+        */
+        uint8_t triggers();
+
+        /**
+            @brief  Values of the last poll: VCELLREP (V), CURRREP (uA), REPSOC (%), FPROTSTAT.IsDis cleared.
+                    0 (false) if the last poll failed
+        */
+        float vcell();
+        int32_t currentMicroAmps();
+        float soc();
+        bool charging();
+
+        /**
+            @brief  Returns the bus time report since begin()
+        */
+        MAX17332_AdaptiveReport report();
+
+    private:
+        uint32_t busTime(const MAX17332_BusUsage& usage);           ///< modelled us at _frequency
+
+        MAX17332* _gauge;
+        MAX17332_ReadPlan _plan;
+        uint16_t _words[MAX17332_PLAN_MAX_REGS];
+        uint16_t _failed;       ///< failed burst mask of the last poll, all before the first one
+        uint32_t _min;
+        uint32_t _max;
+        int32_t _threshold;
+        int32_t _current;       ///< uA, last successful poll
+        bool _charging;         ///< last successful poll
+        uint32_t _soc_time;     ///< millis() of the last poll seeing dSOCi
+        uint32_t _soc_gap;      ///< ms between the last two dSOCi of the charge, 0 if unknown
+        uint32_t _poll_us;      ///< bus_us without the dSOCi clears
+        uint32_t _frequency;
+        uint32_t _interval;
+        uint32_t _start;
+        uint32_t _last;
+        volatile bool _due;     ///< poll on the next service() regardless of the interval
+        uint8_t _triggers;
+        MAX17332_AdaptiveReport _report;
+
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_BusStats.h"
+
+#if MAX17332_BUS_STATS
+
+static void count(MAX17332_BusCounters* counters, uint32_t transactions, uint32_t bytes, uint8_t result, uint32_t elapsed) {
+    counters->calls++;
+    counters->transactions += transactions;
+    counters->bytes += bytes;
+    counters->micros += elapsed;
+
+    if (result == MAX17332_STATS_NACK) {
+        counters->nacks++;
+    } else if (result == MAX17332_STATS_SHORT_READ) {
+        counters->short_reads++;
+    }
+}
+
+void MAX17332_statsRecord(MAX17332_BusStats* stats, uint8_t op, uint16_t address, uint32_t transactions, uint32_t bytes, uint8_t result, uint32_t elapsed) {
+
+    if (!stats) {
+        return;
+    }
+
+    count(&stats->op[op], transactions, bytes, result, elapsed);
+    count(&stats->bank[address < 0x100 ? 0 : 1], transactions, bytes, result, elapsed);
+
+    MAX17332_BusCounters* counters = &stats->other;
+    for (uint8_t i = 0; i < stats->num_regs; i++) {
+        if (stats->reg[i].address == address) {
+            counters = &stats->reg[i].counters;
+            break;
+        }
+    }
+
+    if (counters == &stats->other && stats->num_regs < MAX17332_STATS_MAX_REGS) {
+        MAX17332_RegisterCounters* reg = &stats->reg[stats->num_regs++];
+        memset(reg, 0, sizeof(*reg));
+        reg->address = address;
+        counters = &reg->counters;
+    }
+
+    count(counters, transactions, bytes, result, elapsed);
+
+    uint8_t bucket = 0;
+    while (bucket < MAX17332_STATS_HIST_BUCKETS - 1 && elapsed >= ((uint32_t) 64 << bucket)) {
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+}
+
+#endif
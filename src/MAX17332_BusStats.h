@@ -0,0 +1,117 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_BUSSTATS_H_
+#define  _MAX17332_BUSSTATS_H_
+
+#include <Arduino.h>
+
+/**
+ * Define MAX17332_BUS_STATS=1 (e.g. as a build flag) to count the bus traffic of the driver.
+ * When 0 the instrumentation compiles to nothing.
+ *
+ * The statistics live in a pool in MAX17332.cpp, so the MAX17332 layout does not depend on the
+ * flag. MAX17332::busStats() only exists in builds with the flag: defining it in a sketch alone
+ * fails at link time
+*/
+#ifndef MAX17332_BUS_STATS
+#define MAX17332_BUS_STATS          0
+#endif
+
+#ifndef MAX17332_BUS_STATS_INSTANCES
+#define MAX17332_BUS_STATS_INSTANCES 4      ///< MAX17332 objects with statistics, further ones are not counted
+#endif
+
+#define MAX17332_STATS_MAX_REGS     16      ///< Registers tracked individually, the rest go to other
+#define MAX17332_STATS_HIST_BUCKETS 12      ///< Bucket i counts latencies below (64 << i) us, the last one the rest
+
+// TRANSACTION RESULTS
+#define MAX17332_STATS_OK           0
+#define MAX17332_STATS_NACK         1
+#define MAX17332_STATS_SHORT_READ   2
+
+/**
+ * Instrumented driver operations
+*/
+enum MAX17332_StatsOp {
+    MAX17332_OP_READ = 0,           ///< readRegisters()
+    MAX17332_OP_WRITE,              ///< writeRegister()
+    MAX17332_OP_WRITE_BURST,        ///< writeRegisters()
+    MAX17332_OP_FREE_MEM,           ///< freeMem()
+    MAX17332_OP_PROTECT_MEM,        ///< protectMem()
+    MAX17332_OP_COUNT
+};
+
+/**
+ * Struct for storing bus counters
+*/
+typedef struct
+{
+    uint32_t calls;
+    uint32_t transactions;
+    uint32_t bytes;                 ///< register address and data bytes, none for a NACKed transaction
+    uint32_t nacks;
+    uint32_t short_reads;
+    uint32_t micros;                ///< total time spent
+
+} MAX17332_BusCounters;
+
+/**
+ * Struct for storing the bus counters of a register (start address of the transaction)
+*/
+typedef struct
+{
+    uint16_t address;
+    MAX17332_BusCounters counters;
+
+} MAX17332_RegisterCounters;
+
+/**
+ * Struct for storing the driver bus statistics
+*/
+typedef struct
+{
+    MAX17332_BusCounters op[MAX17332_OP_COUNT];
+    MAX17332_BusCounters bank[2];                           ///< [0] MAX17332_ADDRESS_L, [1] MAX17332_ADDRESS_H
+    MAX17332_RegisterCounters reg[MAX17332_STATS_MAX_REGS];
+    MAX17332_BusCounters other;                             ///< registers not fitting in reg
+    uint8_t num_regs;
+    uint32_t histogram[MAX17332_STATS_HIST_BUCKETS];        ///< latency of each call
+
+} MAX17332_BusStats;
+
+#if MAX17332_BUS_STATS
+
+/**
+    @brief  Records one driver call
+    @param  stats statistics to update, NULL for none
+    @param  op MAX17332_StatsOp
+    @param  address 9-bit start address
+    @param  transactions i2c transactions issued
+    @param  bytes bytes transferred
+    @param  result MAX17332_STATS_OK, MAX17332_STATS_NACK or MAX17332_STATS_SHORT_READ
+    @param  elapsed call latency (us)
+*/
+void MAX17332_statsRecord(MAX17332_BusStats* stats, uint8_t op, uint16_t address, uint32_t transactions, uint32_t bytes, uint8_t result, uint32_t elapsed);
+
+#define MAX17332_STATS_START()  uint32_t _stats_start = micros()
+#define MAX17332_STATS_RECORD(op, address, transactions, bytes, result) \
+    MAX17332_statsRecord(_stats, op, address, transactions, bytes, result, micros() - _stats_start)
+
+#else
+
+#define MAX17332_STATS_START()  do {} while (0)
+#define MAX17332_STATS_RECORD(op, address, transactions, bytes, result) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Events.h"
+
+static_assert((MAX17332_EVENT_QUEUE_SIZE & (MAX17332_EVENT_QUEUE_SIZE - 1)) == 0 && MAX17332_EVENT_QUEUE_SIZE <= 128,
+              "MAX17332_EVENT_QUEUE_SIZE must be a power of two up to 128");
+
+// Keeps the compiler from moving the event copy across the index update (single core targets)
+#define MAX17332_BARRIER()      __asm__ __volatile__ ("" : : : "memory")
+
+static const uint16_t MAX17332_alert_registers[] = {
+    MAX17332_STATUS_REG,
+    MAX17332_PROT_ALRT_REG,
+    MAX17332_FPROTSTAT_REG
+};
+
+MAX17332_EventQueue::MAX17332_EventQueue(): _head(0), _tail(0) {}
+
+int MAX17332_EventQueue::push(const MAX17332_Event& event) {
+    uint8_t head = _head;
+
+    if ((uint8_t) (head - _tail) >= MAX17332_EVENT_QUEUE_SIZE) {
+        return 0;
+    }
+
+    _events[head & (MAX17332_EVENT_QUEUE_SIZE - 1)] = event;
+    MAX17332_BARRIER();
+    _head = head + 1;
+
+    return 1;
+}
+
+int MAX17332_EventQueue::pop(MAX17332_Event& event) {
+    uint8_t tail = _tail;
+
+    if (tail == _head) {
+        return 0;
+    }
+
+    MAX17332_BARRIER();
+    event = _events[tail & (MAX17332_EVENT_QUEUE_SIZE - 1)];
+    MAX17332_BARRIER();
+    _tail = tail + 1;
+
+    return 1;
+}
+
+uint8_t MAX17332_EventQueue::available() const {
+    return (uint8_t) (_head - _tail);
+}
+
+bool MAX17332_EventQueue::full() const {
+    return available() >= MAX17332_EVENT_QUEUE_SIZE;
+}
+
+MAX17332_Alerts::MAX17332_Alerts(MAX17332& gauge):
+    _gauge(&gauge),
+    _plan(MAX17332_alert_registers, sizeof(MAX17332_alert_registers) / sizeof(MAX17332_alert_registers[0])),
+    _fprotstat(0),
+    _pending(false),
+    _overflows(0)
+{
+    _uncleared[0] = 0;
+    _uncleared[1] = 0;
+    setMasks(MAX17332_EVENT_STATUS_MASK, MAX17332_EVENT_PROT_ALRT_MASK, MAX17332_EVENT_FPROTSTAT_MASK);
+}
+
+int MAX17332_Alerts::begin() {
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+
+    if (_gauge->poll(_plan, words) != 1) {
+        return 0;
+    }
+
+    _fprotstat = _plan.value(words, MAX17332_FPROTSTAT_REG);
+
+    // ALRT may already be asserted: without an edge the ISR would never fire
+    _pending = true;
+
+    return 1;
+}
+
+void MAX17332_Alerts::setMasks(uint16_t status_mask, uint16_t prot_alrt_mask, uint16_t fprotstat_mask) {
+    _masks[MAX17332_EVENT_STATUS] = status_mask;
+    _masks[MAX17332_EVENT_PROT_ALRT] = prot_alrt_mask;
+    _masks[MAX17332_EVENT_FPROTSTAT] = fprotstat_mask;
+}
+
+void MAX17332_Alerts::notify() {
+    _pending = true;
+}
+
+bool MAX17332_Alerts::pending() const {
+    return _pending;
+}
+
+int MAX17332_Alerts::service() {
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+
+    if (!_pending) {
+        return 0;
+    }
+
+    // Cleared before the read: an alert raised meanwhile is serviced on the next call
+    _pending = false;
+
+    if (_gauge->poll(_plan, words) != 1) {
+        _pending = true;
+        return -1;
+    }
+
+    uint32_t now = millis();
+    uint8_t queued = _queue.available();
+
+    // Latched registers: every masked bit is new, as handled bits are cleared below.
+    // Bits queued by a call whose clear failed are still latched: not queued again
+    uint16_t status = _plan.value(words, MAX17332_STATUS_REG) & _masks[MAX17332_EVENT_STATUS] & ~_uncleared[0];
+    uint16_t prot_alrt = _plan.value(words, MAX17332_PROT_ALRT_REG) & _masks[MAX17332_EVENT_PROT_ALRT] & ~_uncleared[1];
+    uint16_t status_handled = queue(MAX17332_EVENT_STATUS, status, now);
+    uint16_t prot_alrt_handled = queue(MAX17332_EVENT_PROT_ALRT, prot_alrt, now);
+
+    // Live register: rising edges against the last service(). Deferred bits are left low to rise again
+    uint16_t fprotstat = _plan.value(words, MAX17332_FPROTSTAT_REG);
+    uint16_t rising = fprotstat & ~_fprotstat & _masks[MAX17332_EVENT_FPROTSTAT];
+    uint16_t fprotstat_handled = queue(MAX17332_EVENT_FPROTSTAT, rising, now);
+    _fprotstat = fprotstat & ~(rising & ~fprotstat_handled);
+
+    queued = _queue.available() - queued;
+
+    if (status != status_handled || prot_alrt != prot_alrt_handled || rising != fprotstat_handled) {
+        _pending = true;
+    }
+
+    _uncleared[0] |= status_handled;
+    _uncleared[1] |= prot_alrt_handled;
+
+    // Retried on the next call until it succeeds
+    if (_gauge->clearStatusBits(_uncleared[0], _uncleared[1]) != 1) {
+        _pending = true;
+        return -1;
+    }
+
+    _uncleared[0] = 0;
+    _uncleared[1] = 0;
+
+    return queued;
+}
+
+uint16_t MAX17332_Alerts::queue(uint8_t source, uint16_t rising, uint32_t now) {
+    uint16_t handled = 0;
+    MAX17332_Event event;
+
+    event.source = source;
+    event.timestamp = now;
+
+    for (uint8_t bit = 0; bit < 16; bit++) {
+        if (!(rising & (1 << bit))) {
+            continue;
+        }
+
+        event.bit = bit;
+        if (!_queue.push(event)) {
+            _overflows++;
+            continue;
+        }
+
+        handled |= (1 << bit);
+    }
+
+    return handled;
+}
+
+int MAX17332_Alerts::read(MAX17332_Event& event) {
+    return _queue.pop(event);
+}
+
+uint8_t MAX17332_Alerts::available() const {
+    return _queue.available();
+}
+
+uint32_t MAX17332_Alerts::overflows() const {
+    return _overflows;
+}
@@ -0,0 +1,153 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_EVENTS_H_
+#define  _MAX17332_EVENTS_H_
+
+#include "MAX17332.h"
+
+// EVENT QUEUE
+#define MAX17332_EVENT_QUEUE_SIZE   16              ///< events, power of two (at most 128)
+
+// DEFAULT EVENT MASKS
+#define MAX17332_EVENT_STATUS_MASK      (STATUS_ALERT_MASK | STATUS_SOCCHANGE_MASK)
+#define MAX17332_EVENT_PROT_ALRT_MASK   0xFFFF
+#define MAX17332_EVENT_FPROTSTAT_MASK   0xFFFF
+
+/**
+ * Register an event bit belongs to
+*/
+enum MAX17332_EventSource {
+    MAX17332_EVENT_STATUS = 0,          ///< STATUS_REG, latched: cleared once handled
+    MAX17332_EVENT_PROT_ALRT,           ///< PROT_ALRT_REG, latched: cleared once handled
+    MAX17332_EVENT_FPROTSTAT            ///< FPROTSTAT_REG, live state: rising edges only
+};
+
+/**
+ * Struct for storing an alert event
+*/
+typedef struct
+{
+    uint8_t source;         ///< MAX17332_EventSource
+    uint8_t bit;            ///< bit number in the source register (e.g. 12 for STATUS_OVERVOLTAGE_MASK)
+    uint32_t timestamp;     ///< millis() of the service() call that saw the bit rise
+
+} MAX17332_Event;
+
+/**
+ * Fixed-size single producer single consumer event queue. Lock-free: the producer only
+ * writes _head and the consumer only writes _tail, each a single byte
+*/
+class MAX17332_EventQueue {
+
+    public:
+        MAX17332_EventQueue();
+
+        /**
+            @brief  Appends an event
+            @return 1 if OK; 0 if the queue is full
+        */
+        int push(const MAX17332_Event& event);
+
+        /**
+            @brief  Removes the oldest event
+            @return 1 if OK; 0 if the queue is empty
+        */
+        int pop(MAX17332_Event& event);
+
+        /**
+            @brief  Returns the number of queued events
+        */
+        uint8_t available() const;
+
+        /**
+            @brief  Returns true if push() would fail
+        */
+        bool full() const;
+
+    private:
+        MAX17332_Event _events[MAX17332_EVENT_QUEUE_SIZE];
+        volatile uint8_t _head;     ///< free-running write index
+        volatile uint8_t _tail;     ///< free-running read index
+
+};
+
+/**
+ * ALRT pin event mode. The ISR only calls notify(); service() reads STATUS_REG, PROT_ALRT_REG
+ * and FPROTSTAT_REG in one plan, queues an event per rising bit and clears only the handled bits
+*/
+class MAX17332_Alerts {
+
+    public:
+        MAX17332_Alerts(MAX17332& gauge);
+
+        /**
+            @brief  Reads the current registers as a baseline and arms the event mode
+            @return 1 if OK; 0 on transmission error
+        */
+        int begin();
+
+        /**
+            @brief  Sets the bits that produce events. Other latched bits are left untouched
+        */
+        void setMasks(uint16_t status_mask, uint16_t prot_alrt_mask, uint16_t fprotstat_mask);
+
+        /**
+            @brief  Flags pending alerts. Interrupt safe: no bus access
+        */
+        void notify();
+
+        /**
+            @brief  Returns true if notify() was called since the last service()
+        */
+        bool pending() const;
+
+        /**
+            @brief  Reads and decodes the alert registers if notified, queueing events and clearing the handled bits.
+                    Bits that do not fit in the queue stay latched and are retried on the next call.
+                    If clearing fails the queued events are kept and the clear is retried on the next call,
+                    without queueing the same bits again
+            @return number of events queued; 0 if nothing was pending; -1 on transmission error
+        */
+        int service();
+
+        /**
+            @brief  Removes the oldest event
+            @return 1 if OK; 0 if no event is queued
+        */
+        int read(MAX17332_Event& event);
+
+        /**
+            @brief  Returns the number of queued events
+        */
+        uint8_t available() const;
+
+        /**
+            @brief  Returns the number of events deferred to a later service() because of a full queue
+        */
+        uint32_t overflows() const;
+
+    private:
+        uint16_t queue(uint8_t source, uint16_t rising, uint32_t now);
+
+        MAX17332* _gauge;
+        MAX17332_ReadPlan _plan;
+        MAX17332_EventQueue _queue;
+        uint16_t _masks[3];
+        uint16_t _fprotstat;        ///< FPROTSTAT_REG content at the last service(), deferred bits cleared
+        uint16_t _uncleared[2];     ///< STATUS_REG and PROT_ALRT_REG bits queued but not cleared yet
+        volatile bool _pending;
+        uint32_t _overflows;
+
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Fingerprint.h"
+
+uint32_t MAX17332_crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? MAX17332_CRC32_POLY : 0);
+        }
+    }
+
+    return crc;
+}
+
+uint32_t MAX17332_fingerprintUpdate(uint32_t crc, uint16_t offset, const uint8_t* data, size_t length) {
+
+    for (size_t i = 0; i < length; i++, offset++) {
+        if (offset >= NVM_ROMID_OFFSET && offset < NVM_ROMID_OFFSET + NVM_ROMID_SIZE) {     // SKIP ROMID REGISTERS
+            continue;
+        }
+        crc = MAX17332_crc32Update(crc, &data[i], 1);
+    }
+
+    return crc;
+}
+
+uint32_t MAX17332_fingerprintOf(const uint8_t* data) {
+    return ~MAX17332_fingerprintUpdate(MAX17332_CRC32_INIT, 0, data, NVM_SIZE);
+}
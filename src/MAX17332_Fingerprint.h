@@ -0,0 +1,60 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_FINGERPRINT_H_
+#define  _MAX17332_FINGERPRINT_H_
+
+#include "MAX17332.h"
+
+// CRC-32 (IEEE 802.3, reflected)
+#define MAX17332_CRC32_POLY         0xEDB88320UL
+#define MAX17332_CRC32_INIT         0xFFFFFFFFUL
+
+/**
+    @brief  Updates a CRC-32 with length bytes (bitwise, no table)
+    @param  crc running CRC, start with MAX17332_CRC32_INIT
+    @return updated running CRC. The final CRC is its complement
+*/
+uint32_t MAX17332_crc32Update(uint32_t crc, const uint8_t* data, size_t length);
+
+/**
+    @brief  Updates a shadow RAM fingerprint with length bytes found at offset, skipping ROMID bytes
+    @param  crc running CRC, start with MAX17332_CRC32_INIT
+    @param  offset byte offset of data in the shadow RAM
+    @return updated running CRC. The fingerprint is its complement
+*/
+uint32_t MAX17332_fingerprintUpdate(uint32_t crc, uint16_t offset, const uint8_t* data, size_t length);
+
+/**
+    @brief  Returns the fingerprint of a NVM_SIZE shadow RAM image (CRC-32, ROMID excluded)
+*/
+uint32_t MAX17332_fingerprintOf(const uint8_t* data);
+
+/**
+ * Compile-time versions (C++11 constexpr), e.g.
+ * constexpr uint32_t GOLDEN = MAX17332_fingerprint(golden_image);
+*/
+constexpr uint32_t MAX17332_crc32Bits(uint32_t crc, uint8_t bits) {
+    return bits == 0 ? crc : MAX17332_crc32Bits((crc >> 1) ^ ((crc & 1) ? MAX17332_CRC32_POLY : 0), bits - 1);
+}
+
+constexpr uint32_t MAX17332_fingerprintFrom(const uint8_t* data, size_t i, uint32_t crc) {
+    return i == NVM_SIZE ? ~crc :
+        MAX17332_fingerprintFrom(data, i + 1, (i >= NVM_ROMID_OFFSET && i < NVM_ROMID_OFFSET + NVM_ROMID_SIZE) ?
+            crc : MAX17332_crc32Bits(crc ^ data[i], 8));
+}
+
+constexpr uint32_t MAX17332_fingerprint(const uint8_t* data) {
+    return MAX17332_fingerprintFrom(data, 0, MAX17332_CRC32_INIT);
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Fleet.h"
+
+MAX17332_Mux::MAX17332_Mux(MAX17332_Transport::Bus& bus, uint8_t address): _transport(bus), _address(address), _channel(MAX17332_MUX_NONE), _known(false), _switches(0) {}
+
+int MAX17332_Mux::select(uint8_t channel) {
+
+    if (channel >= MAX17332_MUX_CHANNELS && channel != MAX17332_MUX_NONE) {
+        return 0;
+    }
+
+    if (_known && channel == _channel) {
+        return 1;
+    }
+
+    // The control byte takes the place of the register address
+    if (_transport.write(_address, channel == MAX17332_MUX_NONE ? 0x00 : (1 << channel), NULL, 0) != 1) {
+        _known = false;
+        return 0;
+    }
+
+    _channel = channel;
+    _known = true;
+    _switches++;
+
+    return 1;
+}
+
+void MAX17332_Mux::invalidate() {
+    _known = false;
+}
+
+uint8_t MAX17332_Mux::channel() {
+    return _known ? _channel : MAX17332_MUX_NONE;
+}
+
+uint32_t MAX17332_Mux::switches() {
+    return _switches;
+}
+
+MAX17332_Transport::Bus* MAX17332_Mux::bus() {
+    return _transport.bus();
+}
+
+MAX17332_Fleet::MAX17332_Fleet(MAX17332_FleetPolicy policy): _size(0), _last(0), _policy(policy), _polls(0) {}
+
+int MAX17332_Fleet::add(MAX17332& gauge, uint32_t period_ms, MAX17332_Mux* mux, uint8_t channel) {
+
+    if (_size >= MAX17332_FLEET_MAX_GAUGES) {
+        return 0;
+    }
+
+    if (mux && channel >= MAX17332_MUX_CHANNELS) {
+        return 0;
+    }
+
+    // Mux index in order of first add(), 0 for direct gauges
+    uint8_t group = 0;
+    if (mux) {
+        uint8_t groups = 0;
+        for (uint8_t j = 0; j < _size; j++) {
+            if (_entries[j].mux == mux) {
+                group = _entries[j].group;
+            }
+            if (_entries[j].group > groups) {
+                groups = _entries[j].group;
+            }
+        }
+        if (!group) {
+            group = groups + 1;
+        }
+    } else {
+        channel = 0;
+    }
+
+    // Keep gauges grouped by mux and channel
+    uint8_t i = _size++;
+    while (i > 0 && (_entries[i - 1].group > group || (_entries[i - 1].group == group && _entries[i - 1].channel > channel))) {
+        _entries[i] = _entries[i - 1];
+        i--;
+    }
+
+    Entry& entry = _entries[i];
+    memset(&entry, 0, sizeof(entry));
+    entry.gauge = &gauge;
+    entry.mux = mux;
+    entry.group = group;
+    entry.channel = channel;
+    entry.period = period_ms;
+    entry.due = millis();
+    _last = _size - 1;
+
+    return 1;
+}
+
+int MAX17332_Fleet::poll() {
+    uint32_t now = millis();
+    int index = next(now);
+
+    if (index < 0) {
+        return -1;
+    }
+
+    Entry& entry = _entries[index];
+    bool ok = (route(entry) == 1) && (entry.gauge->snapshot() == 1);
+
+    entry.result.status = entry.gauge->status;
+    entry.result.timestamp = now;
+    entry.result.polls++;
+    entry.result.errors += ok ? 0 : 1;
+    entry.result.ok = ok;
+
+    // Next deadline from the previous one, without accumulating lateness
+    entry.due += entry.period;
+    if ((int32_t) (now - entry.due) > 0) {
+        entry.due = now;
+    }
+
+    _last = index;
+    _polls++;
+
+    return index;
+}
+
+int MAX17332_Fleet::next(uint32_t now) {
+
+    if (_policy == MAX17332_FLEET_ROUND_ROBIN) {
+        for (uint8_t k = 1; k <= _size; k++) {
+            uint8_t i = (_last + k) % _size;
+            if ((int32_t) (now - _entries[i].due) >= 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Earliest deadline first
+    int best = -1;
+    for (uint8_t i = 0; i < _size; i++) {
+        if ((int32_t) (now - _entries[i].due) < 0) {
+            continue;
+        }
+        if (best < 0 || (int32_t) (_entries[i].due - _entries[best].due) < 0) {
+            best = i;
+        }
+    }
+
+    if (best < 0) {
+        return -1;
+    }
+
+    // A due gauge on an already selected channel avoids a switch if not much later than the earliest one
+    for (uint8_t k = 1; k <= _size; k++) {
+        uint8_t i = (_last + k) % _size;
+        Entry& entry = _entries[i];
+        if ((int32_t) (now - entry.due) >= 0 && routed(entry) &&
+            entry.due - _entries[best].due <= MAX17332_FLEET_SLACK) {
+            return i;
+        }
+    }
+
+    return best;
+}
+
+bool MAX17332_Fleet::routed(Entry& entry) {
+
+    if (entry.mux) {
+        return entry.mux->channel() == entry.channel;
+    }
+
+    // A direct gauge needs every mux on its bus closed
+    for (uint8_t i = 0; i < _size; i++) {
+        MAX17332_Mux* mux = _entries[i].mux;
+        if (mux && mux->bus() == entry.gauge->bus() && mux->channel() != MAX17332_MUX_NONE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int MAX17332_Fleet::route(Entry& entry) {
+    MAX17332_Transport::Bus* bus = entry.mux ? entry.mux->bus() : entry.gauge->bus();
+
+    // Close the other muxes on the bus: gauges behind them share the same addresses.
+    // No bus access for muxes already known closed
+    for (uint8_t i = 0; i < _size; i++) {
+        MAX17332_Mux* other = _entries[i].mux;
+        if (other && other != entry.mux && other->bus() == bus) {
+            if (!other->select(MAX17332_MUX_NONE)) {
+                return 0;
+            }
+        }
+    }
+
+    return entry.mux ? entry.mux->select(entry.channel) : 1;
+}
+
+uint8_t MAX17332_Fleet::size() {
+    return _size;
+}
+
+MAX17332& MAX17332_Fleet::gauge(uint8_t index) {
+    return *_entries[index].gauge;
+}
+
+const MAX17332_FleetResult& MAX17332_Fleet::result(uint8_t index) {
+    return _entries[index].result;
+}
+
+uint32_t MAX17332_Fleet::polls() {
+    return _polls;
+}
+
+uint32_t MAX17332_Fleet::muxSwitches() {
+    uint32_t switches = 0;
+
+    for (uint8_t i = 0; i < _size; i++) {
+        MAX17332_Mux* mux = _entries[i].mux;
+        bool counted = false;
+        for (uint8_t j = 0; j < i; j++) {
+            counted |= (_entries[j].mux == mux);
+        }
+        if (mux && !counted) {
+            switches += mux->switches();
+        }
+    }
+
+    return switches;
+}
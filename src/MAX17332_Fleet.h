@@ -0,0 +1,167 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_FLEET_H_
+#define  _MAX17332_FLEET_H_
+
+#include "MAX17332.h"
+
+// I2C MUX (TCA9548 style: one control byte, bit i enables channel i)
+#define MAX17332_MUX_ADDRESS        0x70
+#define MAX17332_MUX_NONE           0xFF            ///< no channel enabled / unknown
+#define MAX17332_MUX_CHANNELS       8
+
+// FLEET
+#define MAX17332_FLEET_MAX_GAUGES   8
+#define MAX17332_FLEET_SLACK        10              ///< ms a gauge on the selected mux channel may jump the deadline queue
+
+/**
+ * TCA9548 style i2c multiplexer. The selected channel is cached so only changes hit the bus
+*/
+class MAX17332_Mux {
+
+    public:
+        MAX17332_Mux(MAX17332_Transport::Bus& bus, uint8_t address = MAX17332_MUX_ADDRESS);
+
+        /**
+            @brief  Enables channel (disables all channels with MAX17332_MUX_NONE). No bus access if already selected
+            @return 1 if OK; 0 on transmission error or channel out of range
+        */
+        int select(uint8_t channel);
+
+        /**
+            @brief  Forgets the cached channel, e.g. after a mux reset
+        */
+        void invalidate();
+
+        /**
+            @brief  Returns the selected channel or MAX17332_MUX_NONE
+        */
+        uint8_t channel();
+
+        /**
+            @brief  Returns the number of channel changes written to the mux
+        */
+        uint32_t switches();
+
+        /**
+            @brief  Returns the bus the mux is on
+        */
+        MAX17332_Transport::Bus* bus();
+
+    private:
+        MAX17332_Transport _transport;
+        uint8_t _address;
+        uint8_t _channel;
+        bool _known;            ///< _channel reflects the mux state
+        uint32_t _switches;
+
+};
+
+/**
+ * Fleet scheduling policies
+*/
+enum MAX17332_FleetPolicy {
+    MAX17332_FLEET_ROUND_ROBIN = 0,     ///< next due gauge in (mux, channel) order
+    MAX17332_FLEET_DEADLINE             ///< most overdue gauge, preferring the selected mux channel
+};
+
+/**
+ * Struct for storing the last snapshot of a fleet gauge
+*/
+typedef struct
+{
+    MAX17332_Status status;
+    uint32_t timestamp;         ///< millis() of the last poll
+    uint32_t polls;
+    uint32_t errors;
+    bool ok;                    ///< last poll succeeded
+
+} MAX17332_FleetResult;
+
+/**
+ * Polls the snapshot of several gauges, on one or more buses and behind i2c muxes
+*/
+class MAX17332_Fleet {
+
+    public:
+        MAX17332_Fleet(MAX17332_FleetPolicy policy = MAX17332_FLEET_ROUND_ROBIN);
+
+        /**
+            @brief  Adds a gauge. Gauges are grouped by mux (direct gauges first, then muxes in the order they
+                    were first added) and by channel, so round robin switches channels once per cycle.
+                    Before a direct gauge is polled every mux on its bus is closed
+            @param  gauge MAX17332 on its bus (begin() already called)
+            @param  period_ms polling period, 0 to poll as often as possible
+            @param  mux optional mux the gauge is behind
+            @param  channel mux channel
+            @return 1 if OK; 0 if the fleet is full
+        */
+        int add(MAX17332& gauge, uint32_t period_ms = 0, MAX17332_Mux* mux = NULL, uint8_t channel = 0);
+
+        /**
+            @brief  Polls the snapshot of at most one due gauge
+            @return index of the polled gauge (see gauge()); -1 if none was due
+        */
+        int poll();
+
+        /**
+            @brief  Returns the number of gauges
+        */
+        uint8_t size();
+
+        /**
+            @brief  Returns the i-th gauge
+        */
+        MAX17332& gauge(uint8_t index);
+
+        /**
+            @brief  Returns the last result of the i-th gauge
+        */
+        const MAX17332_FleetResult& result(uint8_t index);
+
+        /**
+            @brief  Returns the total number of snapshots taken
+        */
+        uint32_t polls();
+
+        /**
+            @brief  Returns the total number of mux channel changes
+        */
+        uint32_t muxSwitches();
+
+    private:
+        typedef struct
+        {
+            MAX17332* gauge;
+            MAX17332_Mux* mux;
+            uint8_t group;              ///< 0 for direct gauges, then 1 + mux index in order of first add()
+            uint8_t channel;
+            uint32_t period;
+            uint32_t due;               ///< millis() of the next poll
+            MAX17332_FleetResult result;
+
+        } Entry;
+
+        int next(uint32_t now);
+        bool routed(Entry& entry);      ///< polling entry needs no mux change
+        int route(Entry& entry);
+
+        Entry _entries[MAX17332_FLEET_MAX_GAUGES];
+        uint8_t _size;
+        uint8_t _last;                  ///< last polled index (round robin)
+        MAX17332_FleetPolicy _policy;
+        uint32_t _polls;
+
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Frame.h"
+#include "MAX17332_Fingerprint.h"
+
+MAX17332_FrameWriter::MAX17332_FrameWriter(Print& out): _out(&out), _crc(MAX17332_CRC32_INIT), _remaining(0), _ok(true) {}
+
+void MAX17332_FrameWriter::begin(uint8_t type, uint16_t address, uint16_t length) {
+    const uint8_t magic[] = { MAX17332_FRAME_MAGIC_0, MAX17332_FRAME_MAGIC_1 };
+    const uint8_t header[] = {
+        type,
+        (uint8_t) (address & 0xFF), (uint8_t) (address >> 8),
+        (uint8_t) (length & 0xFF), (uint8_t) (length >> 8)
+    };
+
+    _crc = MAX17332_CRC32_INIT;
+    _ok = true;
+
+    emit(magic, sizeof(magic), false);
+    emit(header, sizeof(header), true);
+
+    _remaining = length;
+}
+
+void MAX17332_FrameWriter::write(const uint8_t* data, size_t length) {
+    if (length > _remaining) {
+        _ok = false;
+        length = _remaining;
+    }
+
+    emit(data, length, true);
+    _remaining -= length;
+}
+
+void MAX17332_FrameWriter::write16(uint16_t value) {
+    const uint8_t data[] = { (uint8_t) (value & 0xFF), (uint8_t) (value >> 8) };
+
+    write(data, sizeof(data));
+}
+
+int MAX17332_FrameWriter::end() {
+    uint32_t crc = ~_crc;
+    const uint8_t data[] = {
+        (uint8_t) (crc & 0xFF), (uint8_t) ((crc >> 8) & 0xFF),
+        (uint8_t) ((crc >> 16) & 0xFF), (uint8_t) (crc >> 24)
+    };
+
+    // A short frame gets a CRC anyway: the decoder rejects it
+    emit(data, sizeof(data), false);
+
+    return (_ok && _remaining == 0) ? 1 : 0;
+}
+
+void MAX17332_FrameWriter::emit(const uint8_t* data, size_t length, bool crc) {
+    if (crc) {
+        _crc = MAX17332_crc32Update(_crc, data, length);
+    }
+
+    if (_out->write(data, length) != length) {
+        _ok = false;
+    }
+}
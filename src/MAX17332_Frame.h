@@ -0,0 +1,78 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_FRAME_H_
+#define  _MAX17332_FRAME_H_
+
+#include <Arduino.h>
+
+/*
+ * Binary frame, little-endian:
+ *
+ *   magic (2) | type (1) | address (2) | length (2) | payload (length) | CRC-32 (4)
+ *
+ * The CRC-32 (IEEE, as zlib.crc32) covers type, address, length and payload.
+ * MAX17332_FRAME_BLOCK: payload is the register block starting at address (9-bit), 2 bytes per register.
+ * MAX17332_FRAME_REGISTERS: address is 0, payload is (register address, value) pairs of 2 bytes each.
+ * extras/tools/max17332_frames.py decodes frames back into images and tables.
+*/
+#define MAX17332_FRAME_MAGIC_0      0xA5
+#define MAX17332_FRAME_MAGIC_1      0x17
+#define MAX17332_FRAME_BLOCK        0x01
+#define MAX17332_FRAME_REGISTERS    0x02
+#define MAX17332_FRAME_HEADER_SIZE  7           ///< bytes, magic to length
+#define MAX17332_FRAME_CRC_SIZE     4
+
+/**
+ * Writes one frame through a Print in a single pass. The payload can be written in chunks
+ * as it is read, so no frame sized buffer is needed
+*/
+class MAX17332_FrameWriter {
+
+    public:
+        MAX17332_FrameWriter(Print& out);
+
+        /**
+            @brief  Writes the frame header
+            @param  type MAX17332_FRAME_BLOCK or MAX17332_FRAME_REGISTERS
+            @param  address first register of a block frame; 0 otherwise
+            @param  length payload length in bytes
+        */
+        void begin(uint8_t type, uint16_t address, uint16_t length);
+
+        /**
+            @brief  Writes a payload chunk
+        */
+        void write(const uint8_t* data, size_t length);
+
+        /**
+            @brief  Writes a 16-bit payload value
+        */
+        void write16(uint16_t value);
+
+        /**
+            @brief  Writes the CRC and closes the frame
+            @return 1 if OK; 0 if the payload length does not match the header or the Print refused bytes
+        */
+        int end();
+
+    private:
+        void emit(const uint8_t* data, size_t length, bool crc);
+
+        Print* _out;
+        uint32_t _crc;
+        uint16_t _remaining;
+        bool _ok;
+
+};
+
+#endif
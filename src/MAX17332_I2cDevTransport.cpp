@@ -0,0 +1,126 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "MAX17332_I2cDevTransport.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+static int systemIoctl(int fd, unsigned long request, void* arg) {
+    return ::ioctl(fd, request, arg);
+}
+
+MAX17332_I2cDevBus::MAX17332_I2cDevBus(const char* path, MAX17332_IoctlFn ioctl_fn):
+    _path(path), _fd(-1), _ioctl(ioctl_fn ? ioctl_fn : systemIoctl), _transfers(0) {}
+
+MAX17332_I2cDevBus::~MAX17332_I2cDevBus() {
+    close();
+}
+
+int MAX17332_I2cDevBus::open() {
+    if (_fd < 0) {
+        _fd = ::open(_path, O_RDWR);
+    }
+
+    return _fd >= 0 ? 1 : 0;
+}
+
+void MAX17332_I2cDevBus::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool MAX17332_I2cDevBus::isOpen() {
+    return _fd >= 0;
+}
+
+int MAX17332_I2cDevBus::transfer(struct i2c_msg* messages, uint32_t count) {
+    struct i2c_rdwr_ioctl_data rdwr;
+
+    rdwr.msgs = messages;
+    rdwr.nmsgs = count;
+    _transfers++;
+
+    return _ioctl(_fd, I2C_RDWR, &rdwr) < 0 ? 0 : 1;
+}
+
+uint32_t MAX17332_I2cDevBus::transfers() {
+    return _transfers;
+}
+
+MAX17332_I2cDevTransport::MAX17332_I2cDevTransport(MAX17332_I2cDevBus& bus): _bus(&bus), _read_result(0) {}
+
+void MAX17332_I2cDevTransport::begin() {
+    _bus->open();
+}
+
+void MAX17332_I2cDevTransport::end() {
+    _bus->close();
+}
+
+int MAX17332_I2cDevTransport::read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    struct i2c_msg messages[2];
+
+    messages[0].addr = i2c_address;
+    messages[0].flags = 0;
+    messages[0].len = 1;
+    messages[0].buf = &reg;
+
+    messages[1].addr = i2c_address;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = length;
+    messages[1].buf = data;
+
+    return _bus->transfer(messages, 2) ? 1 : -1;
+}
+
+int MAX17332_I2cDevTransport::write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length) {
+    uint8_t buffer[MAX17332_I2CDEV_MAX_WRITE];
+    struct i2c_msg message;
+
+    if (1 + length > sizeof(buffer)) {
+        return 0;
+    }
+
+    buffer[0] = reg;
+    if (length) {
+        memcpy(&buffer[1], data, length);
+    }
+
+    message.addr = i2c_address;
+    message.flags = 0;
+    message.len = 1 + length;
+    message.buf = buffer;
+
+    return _bus->transfer(&message, 1);
+}
+
+void MAX17332_I2cDevTransport::beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    _read_result = read(i2c_address, reg, data, length);
+}
+
+int MAX17332_I2cDevTransport::pollRead() {
+    return _read_result;
+}
+
+MAX17332_I2cDevBus* MAX17332_I2cDevTransport::bus() {
+    return _bus;
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_I2CDEV_TRANSPORT_H_
+#define  _MAX17332_I2CDEV_TRANSPORT_H_
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/i2c.h>
+
+#define MAX17332_I2CDEV_MAX_WRITE   256             ///< bytes, register byte included
+
+/**
+ * ioctl() replacement, e.g. an in-process fake adapter for tests
+*/
+typedef int (*MAX17332_IoctlFn)(int fd, unsigned long request, void* arg);
+
+/**
+ * Linux i2c-dev adapter (/dev/i2c-N)
+*/
+class MAX17332_I2cDevBus {
+
+    public:
+        /**
+            @param  path adapter device, e.g. "/dev/i2c-1"
+            @param  ioctl_fn optional ioctl() replacement
+        */
+        MAX17332_I2cDevBus(const char* path, MAX17332_IoctlFn ioctl_fn = NULL);
+        ~MAX17332_I2cDevBus();
+
+        /**
+            @brief  Opens the adapter (no effect if already open)
+            @return 1 if OK; 0 on error (see errno)
+        */
+        int open();
+
+        void close();
+
+        bool isOpen();
+
+        /**
+            @brief  Runs messages as one combined transfer (I2C_RDWR): repeated starts between messages, one stop
+            @return 1 if OK; 0 on error
+        */
+        int transfer(struct i2c_msg* messages, uint32_t count);
+
+        /**
+            @brief  Returns the number of I2C_RDWR ioctls issued
+        */
+        uint32_t transfers();
+
+    private:
+        const char* _path;
+        int _fd;
+        MAX17332_IoctlFn _ioctl;
+        uint32_t _transfers;
+
+};
+
+/**
+ * i2c-dev transport (see MAX17332_Transport.h). A register read is a single I2C_RDWR ioctl
+*/
+class MAX17332_I2cDevTransport {
+
+    public:
+        typedef MAX17332_I2cDevBus Bus;
+
+        MAX17332_I2cDevTransport(MAX17332_I2cDevBus& bus);
+
+        void begin();
+        void end();
+
+        /**
+            @brief  Register write and read in one combined transfer
+            @return 1 if OK; -1 on transfer error
+        */
+        int read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+
+        /**
+            @brief  Writes reg followed by length bytes of data in one transaction
+            @return 1 if OK; 0 on transfer error or if longer than MAX17332_I2CDEV_MAX_WRITE
+        */
+        int write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length);
+
+        /**
+            @brief  Starts a split-phase read. Blocking fallback: the read completes here
+        */
+        void beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+
+        /**
+            @brief  Returns the result of the read started by beginRead()
+            @return MAX17332_TRANSPORT_PENDING while in flight; then as read()
+        */
+        int pollRead();
+
+        MAX17332_I2cDevBus* bus();
+
+    private:
+        MAX17332_I2cDevBus* _bus;
+        int _read_result;       ///< result of the last beginRead()
+
+};
+
+#else
+#error "MAX17332_TRANSPORT_I2CDEV needs Linux i2c-dev"
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_NVM_IMAGE_H_
+#define  _MAX17332_NVM_IMAGE_H_
+
+#include "MAX17332.h"
+#include "MAX17332_Fingerprint.h"
+
+#define NVM_END_ADDRESS         (NVM_START_ADDRESS + NVM_SIZE / 2)                  ///< first register after the shadow RAM
+#define NVM_ROMID_START_ADDRESS (NVM_START_ADDRESS + NVM_ROMID_OFFSET / 2)
+#define NVM_ROMID_END_ADDRESS   (NVM_ROMID_START_ADDRESS + NVM_ROMID_SIZE / 2)
+
+/**
+ * Shadow RAM word, checked at compile time
+*/
+template <uint16_t ADDRESS, uint16_t VALUE>
+struct MAX17332_Word {
+    static_assert(ADDRESS >= NVM_START_ADDRESS && ADDRESS < NVM_END_ADDRESS, "register outside the shadow RAM (0x180 - 0x1EF)");
+    static_assert(ADDRESS < NVM_ROMID_START_ADDRESS || ADDRESS >= NVM_ROMID_END_ADDRESS, "ROMID registers are read only");
+
+    static const uint16_t address = ADDRESS;
+    static const uint16_t value = VALUE;
+};
+
+/**
+ * Named shadow RAM registers
+*/
+namespace MAX17332_Nvm {
+
+    template <uint16_t UOHM>
+    struct nRSense : MAX17332_Word<MAX17332_RSENSE_REG, UOHM> {
+        static_assert(UOHM > 0, "nRSense must not be 0");
+    };
+
+    template <uint16_t VALUE>
+    struct nBattStatus : MAX17332_Word<MAX17332_N_BATT_STATUS_REG, VALUE> {
+        static_assert((VALUE & NBATTSTATUS_PERMFAIL_MASK) == 0, "nBattStatus image must not set PermFail");
+    };
+
+    template <uint16_t VALUE>
+    struct UserMem1C6 : MAX17332_Word<MAX17332_USERMEM_1C6, VALUE> {};
+
+    template <uint16_t VALUE>
+    struct UserMem1E0 : MAX17332_Word<MAX17332_USERMEM_1E0, VALUE> {};
+
+}
+
+/**
+ * Compile-time lookup over a list of MAX17332_Word
+*/
+template <typename... WORDS>
+struct MAX17332_WordList {
+    static constexpr uint16_t get(uint16_t) { return 0; }
+    static constexpr uint8_t count(uint16_t) { return 0; }
+    static constexpr bool unique() { return true; }
+    static void apply(uint8_t*) {}
+};
+
+template <typename WORD, typename... REST>
+struct MAX17332_WordList<WORD, REST...> {
+    static constexpr uint16_t get(uint16_t address) {
+        return address == WORD::address ? WORD::value : MAX17332_WordList<REST...>::get(address);
+    }
+    static constexpr uint8_t count(uint16_t address) {
+        return (address == WORD::address ? 1 : 0) + MAX17332_WordList<REST...>::count(address);
+    }
+    static constexpr bool unique() {
+        return MAX17332_WordList<REST...>::count(WORD::address) == 0 && MAX17332_WordList<REST...>::unique();
+    }
+    static void apply(uint8_t* image) {
+        image[(WORD::address - NVM_START_ADDRESS) * 2] = WORD::value & 0xFF;
+        image[(WORD::address - NVM_START_ADDRESS) * 2 + 1] = WORD::value >> 8;
+        MAX17332_WordList<REST...>::apply(image);
+    }
+};
+
+/**
+ * Base image of MAX17332_NvmImage: every word 0
+*/
+struct MAX17332_NvmBlank {
+    static constexpr uint8_t byteAt(size_t) { return 0; }
+};
+
+/**
+ * Base image from a captured shadow RAM, e.g. a shadowMemDump() decoded by
+ * extras/tools/max17332_frames.py --base. DUMP is a struct with a static constexpr data array:
+ *
+ *   struct PackDump { static constexpr uint8_t data[NVM_SIZE] = { 0x.., ... }; };
+ *   constexpr uint8_t PackDump::data[NVM_SIZE];
+*/
+template <typename DUMP>
+struct MAX17332_NvmBase {
+    static constexpr uint8_t byteAt(size_t offset) { return DUMP::data[offset]; }
+};
+
+template <size_t... I>
+struct MAX17332_Indices {};
+
+template <size_t N, size_t... I>
+struct MAX17332_MakeIndices : MAX17332_MakeIndices<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MAX17332_MakeIndices<0, I...> {
+    typedef MAX17332_Indices<I...> type;
+};
+
+template <typename BASE, typename LIST, typename INDICES>
+struct MAX17332_NvmBytes;
+
+template <typename BASE, typename LIST, size_t... I>
+struct MAX17332_NvmBytes<BASE, LIST, MAX17332_Indices<I...> > {
+    static constexpr uint8_t byteAt(size_t offset) {
+        return LIST::count(NVM_START_ADDRESS + offset / 2) ?
+            (LIST::get(NVM_START_ADDRESS + offset / 2) >> (8 * (offset % 2))) & 0xFF : BASE::byteAt(offset);
+    }
+
+    static constexpr uint8_t data[NVM_SIZE] = { byteAt(I)... };
+};
+
+template <typename BASE, typename LIST, size_t... I>
+constexpr uint8_t MAX17332_NvmBytes<BASE, LIST, MAX17332_Indices<I...> >::data[NVM_SIZE];
+
+/**
+ * Shadow RAM image built at compile time from a base image and named words, little-endian at their
+ * NVM_START_ADDRESS offset. Start from a dump of the pack configuration (MAX17332_NvmBase) so the
+ * unlisted model and protection words are kept. Pass data to writeShadowMemDiff() or
+ * MAX17332_Programmer::writeNVM(), e.g.
+ *
+ *   typedef MAX17332_NvmPatch<MAX17332_NvmBase<PackDump>, MAX17332_Nvm::nRSense<10000> > Config;
+ *   MAX17332_Programmer programmer(BMS);
+ *   programmer.writeNVM(Config::data);
+ *   static_assert(Config::fingerprint() == 0x..., "configuration changed");
+*/
+template <typename BASE, typename... WORDS>
+struct MAX17332_NvmPatch : MAX17332_NvmBytes<BASE, MAX17332_WordList<WORDS...>, typename MAX17332_MakeIndices<NVM_SIZE>::type> {
+    static_assert(MAX17332_WordList<WORDS...>::unique(), "register listed twice in the image");
+
+    /**
+        @brief  Returns the word at a shadow RAM address
+    */
+    static constexpr uint16_t word(uint16_t address) {
+        return MAX17332_WordList<WORDS...>::count(address) ? MAX17332_WordList<WORDS...>::get(address) :
+            BASE::byteAt((address - NVM_START_ADDRESS) * 2) | (BASE::byteAt((address - NVM_START_ADDRESS) * 2 + 1) << 8);
+    }
+
+    /**
+        @brief  Returns the image fingerprint (see MAX17332_fingerprint())
+    */
+    static constexpr uint32_t fingerprint() {
+        return MAX17332_fingerprint(MAX17332_NvmPatch::data);
+    }
+
+    /**
+        @brief  Writes only the listed words into image, e.g. a shadowMemDump() read at run time
+        @param  image NVM_SIZE data array
+    */
+    static void apply(uint8_t* image) {
+        MAX17332_WordList<WORDS...>::apply(image);
+    }
+};
+
+/**
+ * Shadow RAM image with every unlisted word 0. Only for a complete configuration: written to a
+ * pack it clears the model and protection words not listed. To change some words of a pack use
+ * apply() on its shadowMemDump() or MAX17332_NvmPatch with a captured base
+*/
+template <typename... WORDS>
+struct MAX17332_NvmImage : MAX17332_NvmPatch<MAX17332_NvmBlank, WORDS...> {};
+
+#endif
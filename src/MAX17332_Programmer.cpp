@@ -11,10 +11,385 @@
 */
 
 #include "MAX17332_Programmer.h"
+#include "MAX17332_Fingerprint.h"
 
-MAX17332_Programmer::MAX17332_Programmer(MAX17332& bms): _bms(&bms){}
+MAX17332_Programmer::MAX17332_Programmer(MAX17332& bms): _bms(&bms), _data(NULL), _state(MAX17332_PROG_IDLE), _result(0),
+    _copy_timeout(MAX17332_PROG_COPY_TIMEOUT), _reset_timeout(MAX17332_PROG_RESET_TIMEOUT), _poll_interval(MAX17332_PROG_POLL_INTERVAL),
+    _reserve(MAX17332_PROG_RESERVE), _refuse(true), _log(NULL), _saved_word(0) {
+    memset(&_last_copy, 0, sizeof(_last_copy));
+}
 MAX17332_Programmer::~MAX17332_Programmer(){}
 
 int MAX17332_Programmer::writeNVM(const uint8_t* data) {
-    return _bms->writeNVM(data);
+
+    if (_bms->compareWithMem(data) == 1) {
+        return 2;
+    }
+
+    int remaining = _bms->readRemainingUpdates();
+    if (remaining < 0) {
+        return remaining == MAX17332_TIMEOUT ? MAX17332_TIMEOUT : 0;
+    }
+
+    if (!allowCopy(remaining)) {
+        return MAX17332_PROG_NO_BUDGET;
+    }
+
+    logCopyStart(data, remaining);
+    int ret = _bms->copyNVM(data);
+    logCopyEnd(ret);
+
+    return ret;
+}
+
+int MAX17332_Programmer::start(const uint8_t* data) {
+
+    if (_state != MAX17332_PROG_IDLE && _state != MAX17332_PROG_DONE) {
+        return 0;
+    }
+
+    _data = data;
+    _result = 1;
+    enter(MAX17332_PROG_COMPARE);
+
+    return 1;
+}
+
+int MAX17332_Programmer::poll() {
+    uint32_t now = millis();
+    uint32_t elapsed = now - _phase_start;
+    bool poll_due = (now - _last_poll >= _poll_interval);
+
+    switch (_state) {
+        case MAX17332_PROG_IDLE:
+        case MAX17332_PROG_DONE:
+            return _result;
+
+        case MAX17332_PROG_COMPARE:
+            {
+                // A cached fingerprint answers without the bus, otherwise one page per poll
+                bool known = _bms->_fingerprint_valid;
+                int ret = known ? _bms->compareWithMem(_data) : _bms->comparePage(_data, _page);
+
+                if (ret == 1 && !known && ++_page < NVM_SIZE / NVM_PAGE_SIZE) {
+                    break;
+                }
+                if (ret == 1) {
+                    _result = 2;
+                    enter(MAX17332_PROG_DONE);
+                    return _result;
+                }
+            }
+            enter(MAX17332_PROG_UNLOCK);
+            break;
+
+        case MAX17332_PROG_UNLOCK:
+            if (!_bms->freeMem()) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_BUDGET);
+            break;
+
+        case MAX17332_PROG_BUDGET:
+            {
+                int word = _bms->readRegister(MAX17332_NV_UPDATES_REG);
+                if (word < 0) {
+                    fail(0);
+                    break;
+                }
+                _saved_word = word;
+            }
+            enter(MAX17332_PROG_QUERY);
+            break;
+
+        case MAX17332_PROG_QUERY:
+            if (!_bms->sendCommand(NV_REMAINING_UPDATES_CMD)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_WAIT_QUERY);
+            break;
+
+        case MAX17332_PROG_WAIT_QUERY:
+            // No need to poll NVBusy before tRECALL
+            if (elapsed < TRECALL || !poll_due) {
+                break;
+            }
+            _last_poll = now;
+            // Wait for CommStat.NVBusy to clear. A failed read (-1) keeps waiting
+            {
+                int commstat = _bms->readRegister(MAX17332_COMMSTAT_REG);
+                if (commstat >= 0 && (commstat & COMMSTAT_NVBUSY_MASK) == 0) {
+                    enter(MAX17332_PROG_CHECK_BUDGET);
+                } else if (elapsed >= MAX17332_PROG_QUERY_TIMEOUT) {
+                    _result = MAX17332_TIMEOUT;
+                    enter(MAX17332_PROG_RESTORE);
+                }
+            }
+            break;
+
+        case MAX17332_PROG_CHECK_BUDGET:
+            {
+                int raw = _bms->readRegister(MAX17332_NV_UPDATES_REG);
+                if (raw < 0) {
+                    fail(0);
+                    break;
+                }
+                int remaining = MAX17332::decodeRemainingUpdates(raw);
+                if (!allowCopy(remaining)) {
+                    _result = MAX17332_PROG_NO_BUDGET;
+                    enter(MAX17332_PROG_RESTORE);
+                    break;
+                }
+                // The image write below overwrites the update count
+                logCopyStart(_data, remaining);
+            }
+            enter(MAX17332_PROG_WRITE);
+            break;
+
+        case MAX17332_PROG_RESTORE:
+            if (!_bms->writeRegister(MAX17332_NV_UPDATES_REG, _saved_word)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_RELOCK);
+            break;
+
+        case MAX17332_PROG_WRITE:
+            if (!_bms->writeRegisters(NVM_START_ADDRESS, _data, NVM_SIZE)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_CLEAR_ERROR);
+            break;
+
+        case MAX17332_PROG_CLEAR_ERROR:
+            if (!_bms->writeRegister(MAX17332_COMMSTAT_REG, 0x0000)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_COPY);
+            break;
+
+        case MAX17332_PROG_COPY:
+            // This initiates BLOCK COPY!!!
+            if (!_bms->sendCommand(COPY_NV_BLOCK_CMD)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_WAIT_COPY);
+            break;
+
+        case MAX17332_PROG_WAIT_COPY:
+            // No need to poll NVBusy before tBLOCK
+            if (elapsed < TBLOCK || !poll_due) {
+                break;
+            }
+            _last_poll = now;
+            // Wait for CommStat.NVBusy to clear. A failed read (-1) keeps waiting
+            {
+                int commstat = _bms->readRegister(MAX17332_COMMSTAT_REG);
+                if (commstat >= 0 && (commstat & COMMSTAT_NVBUSY_MASK) == 0) {
+                    enter(MAX17332_PROG_CHECK);
+                } else if (elapsed >= _copy_timeout) {
+                    _result = MAX17332_TIMEOUT;
+                    enter(MAX17332_PROG_RELOCK);
+                }
+            }
+            break;
+
+        case MAX17332_PROG_CHECK:
+            {
+                int commstat = _bms->readRegister(MAX17332_COMMSTAT_REG);
+                if (commstat < 0) {
+                    fail(0);
+                    break;
+                }
+                if ((commstat & COMMSTAT_NVERROR_MASK) != 0) {
+                    _result = -1;
+                    enter(MAX17332_PROG_RESET);
+                    break;
+                }
+            }
+            enter(MAX17332_PROG_RECALL);
+            break;
+
+        case MAX17332_PROG_RECALL:
+            // Hardware reset. Recall NVM content to the shadow RAM
+            if (!_bms->sendCommand(HARDWARE_RESET_CMD)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_WAIT_RECALL);
+            break;
+
+        case MAX17332_PROG_WAIT_RECALL:
+            if (elapsed >= MAX17332_PROG_RECALL_TIME) {
+                enter(MAX17332_PROG_VERIFY);
+            }
+            break;
+
+        case MAX17332_PROG_VERIFY:
+            // Verify all of the nonvolatile memory locations are recalled correctly, one page per poll
+            {
+                int ret = _bms->comparePage(_data, _page);
+
+                if (ret == 1 && ++_page < NVM_SIZE / NVM_PAGE_SIZE) {
+                    break;
+                }
+                if (ret == 0) {
+                    _result = -2;
+                } else if (ret < 0) {
+                    _result = 0;
+                }
+            }
+            enter(MAX17332_PROG_REUNLOCK);
+            break;
+
+        case MAX17332_PROG_REUNLOCK:
+            // Write 0x0000 to the CommStat register 3 times in a row to unlock Write Protection and clear NVError bit
+            if (!_bms->freeMem() || !_bms->writeRegister(MAX17332_COMMSTAT_REG, 0x0000)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_RESET);
+            break;
+
+        case MAX17332_PROG_RESET:
+            if (!_bms->writeRegister(MAX17332_CONFIG2_REG, 0x8000)) {
+                fail(0);
+                break;
+            }
+            enter(MAX17332_PROG_WAIT_RESET);
+            break;
+
+        case MAX17332_PROG_WAIT_RESET:
+            if (!poll_due) {
+                break;
+            }
+            _last_poll = now;
+            // Wait for POR_CMD bit to be cleared. A failed read (-1) keeps waiting
+            {
+                int config2 = _bms->readRegister(MAX17332_CONFIG2_REG);
+                if (config2 >= 0 && (config2 & 0x8000) == 0) {
+                    enter(MAX17332_PROG_RELOCK);
+                } else if (elapsed >= _reset_timeout) {
+                    _result = MAX17332_TIMEOUT;
+                    enter(MAX17332_PROG_RELOCK);
+                }
+            }
+            break;
+
+        case MAX17332_PROG_RELOCK:
+            if (!_bms->protectMem() && _result > 0) {
+                _result = 0;
+            }
+            if (_result == 1) {
+                _bms->calibrate();
+                _bms->cacheFingerprint(_data);
+            }
+            enter(MAX17332_PROG_DONE);
+            return _result;
+    }
+
+    return MAX17332_PROG_BUSY;
+}
+
+MAX17332_ProgState MAX17332_Programmer::state() {
+    return _state;
+}
+
+int MAX17332_Programmer::result() {
+    return _result;
+}
+
+void MAX17332_Programmer::setTimeouts(uint32_t copy_ms, uint32_t reset_ms) {
+    _copy_timeout = copy_ms;
+    _reset_timeout = reset_ms;
+}
+
+void MAX17332_Programmer::setPollInterval(uint32_t ms) {
+    _poll_interval = ms;
+}
+
+void MAX17332_Programmer::setReserve(uint8_t reserve, bool refuse) {
+    _reserve = reserve;
+    _refuse = refuse;
+}
+
+void MAX17332_Programmer::setLog(Print* out) {
+    _log = out;
+}
+
+const MAX17332_CopyRecord& MAX17332_Programmer::lastCopy() {
+    return _last_copy;
+}
+
+bool MAX17332_Programmer::allowCopy(int remaining) {
+
+    if (remaining > _reserve) {
+        return true;
+    }
+
+    bool allow = !_refuse && remaining > 0;
+
+    if (_log) {
+        _log->print(allow ? "NVM BUDGET LOW: " : "NVM COPY REFUSED: ");
+        _log->print((unsigned long) remaining);
+        _log->print(" updates left, reserve ");
+        _log->println((unsigned long) _reserve);
+    }
+
+    return allow;
+}
+
+void MAX17332_Programmer::logCopyStart(const uint8_t* data, int remaining) {
+    _last_copy.fingerprint = MAX17332_fingerprintOf(data);
+    _last_copy.timestamp = millis();
+    _last_copy.remaining = remaining;
+    _last_copy.result = MAX17332_PROG_BUSY;
+    _last_copy.copies++;
+
+    if (_log) {
+        _log->print("NVM COPY ");
+        _log->print((unsigned long) _last_copy.copies);
+        _log->print(": fingerprint 0x");
+        _log->print((unsigned long) _last_copy.fingerprint, HEX);
+        _log->print(", ");
+        _log->print((unsigned long) remaining);
+        _log->println(" updates left");
+    }
+}
+
+void MAX17332_Programmer::logCopyEnd(int result) {
+    _last_copy.result = result;
+
+    if (_log) {
+        _log->print("NVM COPY ");
+        _log->print((unsigned long) _last_copy.copies);
+        _log->print(" RESULT: ");
+        _log->println((long) result);
+    }
+}
+
+void MAX17332_Programmer::enter(MAX17332_ProgState state) {
+    if (state == MAX17332_PROG_DONE && _last_copy.result == MAX17332_PROG_BUSY) {
+        logCopyEnd(_result);
+    }
+
+    _state = state;
+    _page = 0;
+    _phase_start = millis();
+    _last_poll = _phase_start - _poll_interval;     // first status read is due immediately
+}
+
+void MAX17332_Programmer::fail(int result) {
+    // Transmission error: still try to restore the word overwritten by the update count query and write protection
+    _result = result;
+    if (_state >= MAX17332_PROG_QUERY && _state <= MAX17332_PROG_CHECK_BUDGET) {
+        enter(MAX17332_PROG_RESTORE);
+    } else {
+        enter(_state == MAX17332_PROG_RELOCK ? MAX17332_PROG_DONE : MAX17332_PROG_RELOCK);
+    }
 }
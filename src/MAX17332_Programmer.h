@@ -15,6 +15,60 @@
 
 #include "MAX17332.h"
 
+// NON-BLOCKING PROGRAMMING DEFAULTS
+#define MAX17332_PROG_COPY_TIMEOUT      (TBLOCK + 2500) ///< ms from COPY_NV_BLOCK_CMD to NVBusy cleared
+#define MAX17332_PROG_RECALL_TIME       10              ///< ms to wait after the hardware reset
+#define MAX17332_PROG_QUERY_TIMEOUT     (TRECALL + MAX17332_WAIT_TIMEOUT) ///< ms from NV_REMAINING_UPDATES_CMD to NVBusy cleared
+#define MAX17332_PROG_RESET_TIMEOUT     1000            ///< ms from CONFIG2 POR_CMD to POR_CMD cleared
+#define MAX17332_PROG_POLL_INTERVAL     50              ///< ms between two status polls
+
+// NVM BUDGET DEFAULTS
+#define MAX17332_PROG_RESERVE           0               ///< block copies kept in reserve: refuse when remaining <= reserve
+
+// PROGRAMMING RESULTS
+#define MAX17332_PROG_BUSY              3               ///< poll() must be called again
+#define MAX17332_PROG_NO_BUDGET         -4              ///< refused: not enough NVM updates left
+
+/**
+ * Non-blocking NVM programming states, in execution order
+*/
+enum MAX17332_ProgState {
+    MAX17332_PROG_IDLE = 0,
+    MAX17332_PROG_COMPARE,          ///< skip programming if the shadow RAM already matches, one page per poll
+    MAX17332_PROG_UNLOCK,
+    MAX17332_PROG_BUDGET,           ///< save the shadow RAM word overwritten by the update count
+    MAX17332_PROG_QUERY,            ///< send NV_REMAINING_UPDATES_CMD
+    MAX17332_PROG_WAIT_QUERY,       ///< wait tRECALL, then CommStat.NVBusy cleared
+    MAX17332_PROG_CHECK_BUDGET,     ///< read the update count and check the reserve
+    MAX17332_PROG_RESTORE,          ///< refused or query failed: restore the saved shadow RAM word, then relock
+    MAX17332_PROG_WRITE,            ///< write the shadow RAM
+    MAX17332_PROG_CLEAR_ERROR,      ///< clear CommStat.NVError
+    MAX17332_PROG_COPY,             ///< send COPY_NV_BLOCK_CMD
+    MAX17332_PROG_WAIT_COPY,        ///< wait tBLOCK, then CommStat.NVBusy cleared
+    MAX17332_PROG_CHECK,            ///< check CommStat.NVError
+    MAX17332_PROG_RECALL,           ///< hardware reset, recalls NVM to the shadow RAM
+    MAX17332_PROG_WAIT_RECALL,
+    MAX17332_PROG_VERIFY,           ///< compare the recalled shadow RAM, one page per poll
+    MAX17332_PROG_REUNLOCK,         ///< unlock and clear NVError after the hardware reset
+    MAX17332_PROG_RESET,            ///< firmware reset (CONFIG2 POR_CMD)
+    MAX17332_PROG_WAIT_RESET,
+    MAX17332_PROG_RELOCK,
+    MAX17332_PROG_DONE
+};
+
+/**
+ * Struct for storing the last NVM block copy
+*/
+typedef struct
+{
+    uint32_t fingerprint;       ///< MAX17332_fingerprintOf() of the image
+    uint32_t timestamp;         ///< millis() at COPY_NV_BLOCK_CMD
+    int8_t remaining;           ///< block copies left before this one
+    int result;                 ///< programming result; MAX17332_PROG_BUSY while running
+    uint16_t copies;            ///< block copies issued by this programmer
+
+} MAX17332_CopyRecord;
+
 class MAX17332_Programmer {
 
     public:
@@ -23,14 +77,94 @@ class MAX17332_Programmer {
 
         /**
             @brief  Exposes MAX17332::writeNVM protected method. NVM is limited to seven writes maximum. Use at own risk!
+                    The remaining updates are checked against the reserve before the block copy
             @param  data const uint8_t input data array. Must be of size NVM_SIZE
-            @return 1 if OK; -1 if NVError; 0 on transmission error
+            @return 2 if already written; 1 if OK; -1 if NVError; -2 on verification error; 0 on transmission error;
+                    MAX17332_TIMEOUT; MAX17332_PROG_NO_BUDGET if refused
         */
         int writeNVM(const uint8_t* data);
 
+        /**
+            @brief  Starts non-blocking NVM programming. Advance it with poll(). NVM is limited to seven writes maximum. Use at own risk!
+            @param  data const uint8_t input data array. Must be of size NVM_SIZE and valid until done
+            @return 1 if started; 0 if programming is already running
+        */
+        int start(const uint8_t* data);
+
+        /**
+            @brief  Advances non-blocking programming by at most one bus operation (a register access,
+                    a shadow RAM page read or write, or an unlock sequence). Never waits
+            @return MAX17332_PROG_BUSY while running, then the result: 2 if already written; 1 if OK;
+                    0 on transmission error; -1 on NVError; -2 on verification error; MAX17332_TIMEOUT;
+                    MAX17332_PROG_NO_BUDGET if refused
+        */
+        int poll();
+
+        /**
+            @brief  Returns the current MAX17332_ProgState
+        */
+        MAX17332_ProgState state();
+
+        /**
+            @brief  Returns the last result (see poll())
+        */
+        int result();
+
+        /**
+            @brief  Sets the non-blocking programming deadlines (ms)
+            @param  copy_ms from COPY_NV_BLOCK_CMD to NVBusy cleared
+            @param  reset_ms from firmware reset request to POR_CMD cleared
+        */
+        void setTimeouts(uint32_t copy_ms, uint32_t reset_ms);
+
+        /**
+            @brief  Sets the interval between two status polls (ms)
+        */
+        void setPollInterval(uint32_t ms);
+
+        /**
+            @brief  Sets the NVM block copies kept in reserve. With remaining <= reserve the copy is refused,
+                    or only logged if refuse is false. A copy is always refused when none is left
+        */
+        void setReserve(uint8_t reserve, bool refuse = true);
+
+        /**
+            @brief  Logs every block copy (image fingerprint, remaining updates, result) and budget refusals to out
+            @param  out destination, e.g. Serial. NULL disables the log
+        */
+        void setLog(Print* out);
+
+        /**
+            @brief  Returns the last block copy. copies is 0 if none was issued
+        */
+        const MAX17332_CopyRecord& lastCopy();
+
     private:
+        void enter(MAX17332_ProgState state);
+        void fail(int result);
+        bool allowCopy(int remaining);
+        void logCopyStart(const uint8_t* data, int remaining);
+        void logCopyEnd(int result);
+
         MAX17332* _bms;
 
+        const uint8_t* _data;
+        MAX17332_ProgState _state;
+        int _result;
+        uint32_t _phase_start;      ///< millis() when the current state was entered
+        uint32_t _last_poll;        ///< millis() of the last status read
+        uint8_t _page;              ///< next shadow RAM page to compare
+
+        uint32_t _copy_timeout;
+        uint32_t _reset_timeout;
+        uint32_t _poll_interval;
+
+        uint8_t _reserve;
+        bool _refuse;
+        Print* _log;
+        MAX17332_CopyRecord _last_copy;
+        uint16_t _saved_word;       ///< shadow RAM word overwritten by NV_REMAINING_UPDATES_CMD
+
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,141 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_ReadPlan.h"
+
+MAX17332_ReadPlan::MAX17332_ReadPlan(uint8_t gap_words): _num_registers(0), _num_bursts(0), _words(0), _gap(gap_words), _built(false) {}
+
+MAX17332_ReadPlan::MAX17332_ReadPlan(const uint16_t* registers, size_t count, uint8_t gap_words): _num_registers(0), _num_bursts(0), _words(0), _gap(gap_words), _built(false) {
+
+    for (size_t i = 0; i < count; i++) {
+        add(registers[i]);
+    }
+
+    build();
+}
+
+int MAX17332_ReadPlan::add(uint16_t address) {
+
+    for (uint8_t i = 0; i < _num_registers; i++) {
+        if (_registers[i] == address) {
+            return 1;
+        }
+    }
+
+    if (_num_registers >= MAX17332_PLAN_MAX_REGS) {
+        return 0;
+    }
+
+    // Keep the set sorted
+    uint8_t i = _num_registers++;
+    while (i > 0 && _registers[i - 1] > address) {
+        _registers[i] = _registers[i - 1];
+        i--;
+    }
+    _registers[i] = address;
+
+    _built = false;
+
+    return 1;
+}
+
+void MAX17332_ReadPlan::clear() {
+    _num_registers = 0;
+    _num_bursts = 0;
+    _words = 0;
+    _built = false;
+}
+
+void MAX17332_ReadPlan::setGap(uint8_t gap_words) {
+    _gap = gap_words;
+    _built = false;
+}
+
+int MAX17332_ReadPlan::build() {
+    _num_bursts = 0;
+    _words = 0;
+
+    for (uint8_t i = 0; i < _num_registers; i++) {
+        uint16_t address = _registers[i];
+
+        if (_num_bursts > 0) {
+            MAX17332_Burst& last = _bursts[_num_bursts - 1];
+            uint16_t end = last.address + last.words;      // first address after the burst
+
+            // Join if in the same bank, the gap is small enough and the burst fits the Wire buffer
+            if ((address >> 8) == (last.address >> 8) &&
+                address - end <= _gap &&
+                address - last.address < MAX17332_PLAN_MAX_BURST_WORDS) {
+                _words += address + 1 - end;
+                last.words = address + 1 - last.address;
+                continue;
+            }
+        }
+
+        if (_num_bursts >= MAX17332_PLAN_MAX_BURSTS) {
+            _num_bursts = 0;
+            _words = 0;
+            return 0;
+        }
+
+        MAX17332_Burst& burst = _bursts[_num_bursts++];
+        burst.address = address;
+        burst.words = 1;
+        burst.offset = _words;
+        _words++;
+    }
+
+    _built = true;
+
+    return 1;
+}
+
+bool MAX17332_ReadPlan::built() const {
+    return _built;
+}
+
+size_t MAX17332_ReadPlan::bursts() const {
+    return _num_bursts;
+}
+
+const MAX17332_Burst& MAX17332_ReadPlan::burst(size_t i) const {
+    return _bursts[i];
+}
+
+size_t MAX17332_ReadPlan::words() const {
+    return _words;
+}
+
+int MAX17332_ReadPlan::index(uint16_t address) const {
+
+    for (uint8_t i = 0; i < _num_bursts; i++) {
+        if (address >= _bursts[i].address && address < _bursts[i].address + _bursts[i].words) {
+            return _bursts[i].offset + (address - _bursts[i].address);
+        }
+    }
+
+    return -1;
+}
+
+int MAX17332_ReadPlan::value(const uint16_t* buffer, uint16_t address, uint16_t failed) const {
+
+    for (uint8_t i = 0; i < _num_bursts; i++) {
+        if (address >= _bursts[i].address && address < _bursts[i].address + _bursts[i].words) {
+            if (failed & (1 << i)) {
+                return -1;
+            }
+            return buffer[_bursts[i].offset + (address - _bursts[i].address)];
+        }
+    }
+
+    return -1;
+}
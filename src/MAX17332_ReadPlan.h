@@ -0,0 +1,142 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_READPLAN_H_
+#define  _MAX17332_READPLAN_H_
+
+#include <Arduino.h>
+
+// PLANNER LIMITS
+#define MAX17332_PLAN_MAX_REGS          16
+#define MAX17332_PLAN_MAX_BURSTS        16
+#define MAX17332_PLAN_MAX_BURST_WORDS   16      ///< 32 bytes, the smallest common Wire buffer
+#define MAX17332_PLAN_GAP_WORDS         1       ///< Unused words cheaper to read than a new transaction
+
+/**
+ * Struct describing one contiguous burst read
+*/
+typedef struct
+{
+    uint16_t address;       ///< 9-bit start address
+    uint8_t words;          ///< number of 16-bit registers read
+    uint16_t offset;        ///< word offset of the burst in the poll buffer
+
+} MAX17332_Burst;
+
+/**
+ * Merges a set of registers into the fewest burst reads per i2c bank
+*/
+class MAX17332_ReadPlan {
+
+    public:
+        MAX17332_ReadPlan(uint8_t gap_words = MAX17332_PLAN_GAP_WORDS);
+
+        /**
+            @brief  Builds a plan from a register list
+            @param  registers array of 9-bit addresses
+            @param  count number of registers
+            @param  gap_words max unused words read to join two registers in the same burst
+        */
+        MAX17332_ReadPlan(const uint16_t* registers, size_t count, uint8_t gap_words = MAX17332_PLAN_GAP_WORDS);
+
+        /**
+            @brief  Adds a register to the set. Duplicates are ignored. The plan must be rebuilt
+            @param  address 9-bit address
+            @return 1 if OK; 0 if the set is full
+        */
+        int add(uint16_t address);
+
+        /**
+            @brief  Removes all registers and bursts
+        */
+        void clear();
+
+        /**
+            @brief  Sets the max unused words read to join two registers. The plan must be rebuilt
+        */
+        void setGap(uint8_t gap_words);
+
+        /**
+            @brief  Merges the register set into bursts
+            @return 1 if OK; 0 if more than MAX17332_PLAN_MAX_BURSTS are needed
+        */
+        int build();
+
+        /**
+            @brief  Returns true if the plan has been built after the last change
+        */
+        bool built() const;
+
+        /**
+            @brief  Returns the number of bursts
+        */
+        size_t bursts() const;
+
+        /**
+            @brief  Returns the i-th burst
+        */
+        const MAX17332_Burst& burst(size_t i) const;
+
+        /**
+            @brief  Returns the size of the poll buffer (16-bit words)
+        */
+        size_t words() const;
+
+        /**
+            @brief  Returns the word index of address in the poll buffer
+            @return index or -1 if address is not covered by the plan
+        */
+        int index(uint16_t address) const;
+
+        /**
+            @brief  Returns the value of address from a polled buffer
+            @param  buffer poll buffer
+            @param  address 9-bit address
+            @param  failed failed burst mask reported by MAX17332::poll
+            @return register content or -1 if not in plan or its burst failed
+        */
+        int value(const uint16_t* buffer, uint16_t address, uint16_t failed = 0) const;
+
+        /**
+            @brief  Returns the decoded value of a MAX17332_Reg register from a polled buffer
+            @param  buffer poll buffer
+            @param  failed failed burst mask reported by MAX17332::poll
+            @return decoded value or the register error value (0.0 or 0xffff)
+        */
+        template <typename R>
+        typename R::type get(const uint16_t* buffer, uint16_t failed = 0) const {
+            int raw = value(buffer, R::address, failed);
+            return raw < 0 ? R::error() : R::decode(raw);
+        }
+
+        /**
+            @brief  Returns the value of a MAX17332_Reg register in integer units from a polled buffer
+            @return integer value or 0 if not in plan or its burst failed
+        */
+        template <typename R>
+        int32_t getInt(const uint16_t* buffer, uint16_t failed = 0) const {
+            int raw = value(buffer, R::address, failed);
+            return raw < 0 ? 0 : R::decodeInt(raw);
+        }
+
+    private:
+        uint16_t _registers[MAX17332_PLAN_MAX_REGS];
+        MAX17332_Burst _bursts[MAX17332_PLAN_MAX_BURSTS];
+        uint8_t _num_registers;
+        uint8_t _num_bursts;
+        uint16_t _words;
+        uint8_t _gap;
+        bool _built;
+
+};
+
+#endif
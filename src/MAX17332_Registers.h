@@ -0,0 +1,115 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_REGISTERS_H_
+#define  _MAX17332_REGISTERS_H_
+
+#include "MAX17332.h"
+
+/**
+ * Raw register content as signed or unsigned integer
+*/
+template <bool SIGNED>
+struct MAX17332_RawValue {
+    static int32_t get(uint16_t raw) { return raw; }
+};
+
+template <>
+struct MAX17332_RawValue<true> {
+    static int32_t get(uint16_t raw) { return static_cast<int16_t>(raw); }
+};
+
+/**
+ * LSB scales as float constants (folded at compile time)
+*/
+struct MAX17332_VoltageLsb { static float value() { return (float) VOLTAGE_LSB; } };                     ///< V
+struct MAX17332_TempLsb { static float value() { return (float) TEMP_LSB; } };                          ///< degC
+struct MAX17332_PercLsb { static float value() { return (float) PERC_LSB; } };                          ///< %
+struct MAX17332_RSenseLsb { static float value() { return (float) RSENSE_LSB; } };                      ///< mOhm
+
+/**
+ * Descriptor of a scaled measurement register.
+ * The integer scale converts raw to integer units as raw * MUL / 2^SHIFT, with no float math
+*/
+template <uint16_t ADDRESS, bool SIGNED, typename LSB, int32_t MUL, uint8_t SHIFT>
+struct MAX17332_Register {
+    typedef float type;
+    static const uint16_t address = ADDRESS;
+    static const bool high_bank = (ADDRESS >= 0x100);       ///< read through MAX17332_ADDRESS_H
+    static const bool is_signed = SIGNED;
+
+    static type decode(uint16_t raw) { return (float) MAX17332_RawValue<SIGNED>::get(raw) * LSB::value(); }
+    static type error() { return 0.0; }
+
+    static int32_t decodeInt(uint16_t raw) { return MAX17332_RawValue<SIGNED>::get(raw) * MUL / (1L << SHIFT); }
+};
+
+/**
+ * Descriptor of a raw 16-bit register (flags, commands, user memory)
+*/
+template <uint16_t ADDRESS>
+struct MAX17332_RawRegister {
+    typedef uint16_t type;
+    static const uint16_t address = ADDRESS;
+    static const bool high_bank = (ADDRESS >= 0x100);
+    static const bool is_signed = false;
+
+    static type decode(uint16_t raw) { return raw; }
+    static type error() { return 0xffff; }
+
+    static int32_t decodeInt(uint16_t raw) { return raw; }
+};
+
+/**
+ * Descriptor of a current register. Its scale depends on the RSense calibrated at runtime, so there is
+ * no static decoder: convert raw words with MAX17332::currentAmps() or MAX17332::currentMicroAmps()
+*/
+template <uint16_t ADDRESS>
+struct MAX17332_CurrentRegister {
+    typedef int16_t type;
+    static const uint16_t address = ADDRESS;
+    static const bool high_bank = (ADDRESS >= 0x100);
+    static const bool is_signed = true;
+};
+
+/**
+ * Register descriptor table, for MAX17332::read<>() and MAX17332_ReadPlan::get<>()
+*/
+namespace MAX17332_Reg {
+    // Measurements. Integer units: uV (78.125 = 625/8), milli degC and milli % (1000/256 = 125/32), uOhm
+    typedef MAX17332_Register<MAX17332_VCELL_REG, false, MAX17332_VoltageLsb, 625, 3>      VCell;
+    typedef MAX17332_Register<MAX17332_VCELLREP_REG, false, MAX17332_VoltageLsb, 625, 3>   VCellRep;
+    typedef MAX17332_Register<MAX17332_TEMP_REG, true, MAX17332_TempLsb, 125, 5>           Temp;
+    typedef MAX17332_Register<MAX17332_AVSOC_REG, false, MAX17332_PercLsb, 125, 5>         AvSoc;
+    typedef MAX17332_Register<MAX17332_REPSOC_REG, false, MAX17332_PercLsb, 125, 5>        RepSoc;
+    typedef MAX17332_Register<MAX17332_RSENSE_REG, false, MAX17332_RSenseLsb, 1, 0>        nRSense;
+
+    // Currents: read<>() and get<>() do not apply, see MAX17332_CurrentRegister
+    typedef MAX17332_CurrentRegister<MAX17332_CURR_REG>         Curr;
+    typedef MAX17332_CurrentRegister<MAX17332_CURRREP_REG>      CurrRep;
+
+    // Raw words
+    typedef MAX17332_RawRegister<MAX17332_STATUS_REG>           Status;
+    typedef MAX17332_RawRegister<MAX17332_DEVNAME_REG>          DevName;
+    typedef MAX17332_RawRegister<MAX17332_COMMSTAT_REG>         CommStat;
+    typedef MAX17332_RawRegister<MAX17332_LOCK_REG>             Lock;
+    typedef MAX17332_RawRegister<MAX17332_CONFIG2_REG>          Config2;
+    typedef MAX17332_RawRegister<MAX17332_CHGSTAT_REG>          ChgStat;
+    typedef MAX17332_RawRegister<MAX17332_PROT_ALRT_REG>        ProtAlrt;
+    typedef MAX17332_RawRegister<MAX17332_PROT_STATUS_REG>      ProtStatus;
+    typedef MAX17332_RawRegister<MAX17332_FPROTSTAT_REG>        FProtStat;
+    typedef MAX17332_RawRegister<MAX17332_N_BATT_STATUS_REG>    nBattStatus;
+    typedef MAX17332_RawRegister<MAX17332_USERMEM_1C6>          UserMem1C6;
+    typedef MAX17332_RawRegister<MAX17332_USERMEM_1E0>          UserMem1E0;
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Sampler.h"
+
+// Measurements and the snapshot() status registers, read by one plan poll
+static const uint16_t sample_registers[] = {
+    MAX17332_VCELLREP_REG,
+    MAX17332_CURRREP_REG,
+    MAX17332_TEMP_REG,
+    MAX17332_REPSOC_REG,
+    MAX17332_STATUS_REG,
+    MAX17332_FPROTSTAT_REG,
+    MAX17332_N_BATT_STATUS_REG,
+    MAX17332_PROT_STATUS_REG,
+    MAX17332_PROT_ALRT_REG,
+    MAX17332_CHGSTAT_REG,
+};
+
+MAX17332_Sampler::MAX17332_Sampler(MAX17332& gauge, uint32_t period_ms): _gauge(&gauge),
+    _plan(sample_registers, sizeof(sample_registers) / sizeof(sample_registers[0])),
+    _period(period_ms), _last(0), _count(0), _sequence(0), _requests(1), _served(0) {
+    memset(_words, 0, sizeof(_words));
+}
+
+int MAX17332_Sampler::sample() {
+    MAX17332_Reading reading;
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+    MAX17332_BusUsage usage;
+
+    int ret = _gauge->poll(_plan, words, &usage);
+
+    reading.sample.timestamp = millis();
+    reading.sample.vcell = _plan.value(words, MAX17332_VCELLREP_REG, usage.failed);
+    reading.sample.current = _plan.value(words, MAX17332_CURRREP_REG, usage.failed);
+    reading.sample.temp = _plan.value(words, MAX17332_TEMP_REG, usage.failed);
+    reading.sample.soc = _plan.value(words, MAX17332_REPSOC_REG, usage.failed);
+
+    // Decoded here, MAX17332::status is left to the tasks owning it
+    reading.status.status_reg = _plan.value(words, MAX17332_STATUS_REG, usage.failed);
+    reading.status.f_prot_stat = _plan.value(words, MAX17332_FPROTSTAT_REG, usage.failed);
+    reading.status.n_batt_status = _plan.value(words, MAX17332_N_BATT_STATUS_REG, usage.failed);
+    reading.status.prot_status = _plan.value(words, MAX17332_PROT_STATUS_REG, usage.failed);
+    reading.status.prot_alrt = _plan.value(words, MAX17332_PROT_ALRT_REG, usage.failed);
+    reading.status.chg_stat = _plan.value(words, MAX17332_CHGSTAT_REG, usage.failed);
+    reading.count = ++_count;
+    reading.result = ret;
+
+    publish(reading);
+    _last = reading.sample.timestamp;
+
+    return ret;
+}
+
+int MAX17332_Sampler::service() {
+    uint8_t requests = __atomic_load_n(&_requests, __ATOMIC_ACQUIRE);
+    bool requested = (requests != _served);
+
+    if (!requested && millis() - _last < _period) {
+        return 2;
+    }
+
+    _served = requests;
+
+    return sample();
+}
+
+void MAX17332_Sampler::request() {
+    // Plain load and store, no read-modify-write: concurrent requests may collapse into one
+    uint8_t requests = __atomic_load_n(&_requests, __ATOMIC_RELAXED);
+    __atomic_store_n(&_requests, (uint8_t) (requests + 1), __ATOMIC_RELEASE);
+}
+
+void MAX17332_Sampler::setPeriod(uint32_t period_ms) {
+    _period = period_ms;
+}
+
+void MAX17332_Sampler::publish(const MAX17332_Reading& reading) {
+    MAX17332_SeqWord words[WORDS];
+    MAX17332_SeqWord sequence = __atomic_load_n(&_sequence, __ATOMIC_RELAXED);
+
+    memset(words, 0, sizeof(words));
+    memcpy(words, &reading, sizeof(reading));
+
+    // Odd: readers started from here on retry. The fence keeps the words below the sequence store
+    __atomic_store_n(&_sequence, (MAX17332_SeqWord) (sequence + 1), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < WORDS; i++) {
+        __atomic_store_n(&_words[i], words[i], __ATOMIC_RELAXED);
+    }
+
+    // Skip 0 on wrap-around, it means nothing published
+    sequence += 2;
+    __atomic_store_n(&_sequence, (MAX17332_SeqWord) (sequence ? sequence : 2), __ATOMIC_RELEASE);
+}
+
+int MAX17332_Sampler::tryRead(MAX17332_Reading& reading) const {
+    MAX17332_SeqWord words[WORDS];
+    MAX17332_SeqWord before = __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE);
+
+    if (before == 0 || (before & 1)) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < WORDS; i++) {
+        words[i] = __atomic_load_n(&_words[i], __ATOMIC_RELAXED);
+    }
+
+    // The fence keeps the words above the second sequence load
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&_sequence, __ATOMIC_RELAXED) != before) {
+        return 0;
+    }
+
+    memcpy(&reading, words, sizeof(reading));
+
+    return 1;
+}
+
+int MAX17332_Sampler::read(MAX17332_Reading& reading, uint16_t max_retries) const {
+
+    for (uint16_t i = 0; i <= max_retries; i++) {
+        if (tryRead(reading)) {
+            return 1;
+        }
+
+        if (__atomic_load_n(&_sequence, __ATOMIC_RELAXED) == 0) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t MAX17332_Sampler::count() const {
+    MAX17332_Reading reading;
+
+    return read(reading) ? reading.count : 0;
+}
@@ -0,0 +1,110 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_SAMPLER_H_
+#define  _MAX17332_SAMPLER_H_
+
+#include "MAX17332.h"
+#include "MAX17332_Telemetry.h"
+
+#define MAX17332_SAMPLER_PERIOD         1000    ///< ms between two samples taken by service()
+#define MAX17332_SAMPLER_MAX_RETRIES    16      ///< read() attempts before giving up on a busy writer
+
+/**
+ * Native word of the published snapshot copy. Plain loads and stores of it are atomic
+*/
+#if defined(__AVR__)
+typedef uint8_t MAX17332_SeqWord;
+#else
+typedef uint32_t MAX17332_SeqWord;
+#endif
+
+/**
+ * Struct for storing a published gauge reading
+*/
+typedef struct
+{
+    MAX17332_Sample sample;     ///< raw measurement words and millis() of the sample
+    MAX17332_Status status;     ///< snapshot() registers, read by the same poll as sample (-1 if failed)
+    uint32_t count;             ///< samples published so far, this one included
+    int32_t result;             ///< 1 if every read of the sample succeeded; 0 otherwise
+
+} MAX17332_Reading;
+
+/**
+ * Owner of a MAX17332 shared by several tasks. Only the owning task calls sample() or service(),
+ * so bus access is serialised; every other task calls read(), which copies the last published
+ * MAX17332_Reading without touching the bus or taking a lock (seqlock: the writer makes the
+ * sequence odd while it copies, readers retry when the sequence was odd or changed)
+*/
+class MAX17332_Sampler {
+
+    public:
+        MAX17332_Sampler(MAX17332& gauge, uint32_t period_ms = MAX17332_SAMPLER_PERIOD);
+
+        /**
+            @brief  Owning task only. Reads measurements and status with one plan poll, then publishes them.
+                    MAX17332::status is not touched
+            @return 1 if OK; 0 if any read failed (the reading is published anyway)
+        */
+        int sample();
+
+        /**
+            @brief  Owning task only. Samples when the period has elapsed or a sample was requested
+            @return as sample(); 2 if nothing was due
+        */
+        int service();
+
+        /**
+            @brief  Any task. Asks the owning task for a sample at its next service()
+        */
+        void request();
+
+        void setPeriod(uint32_t period_ms);
+
+        /**
+            @brief  Any task. Copies the last published reading
+            @param  reading output
+            @param  max_retries attempts while the writer is publishing
+            @return 1 if OK; 0 if nothing was published yet or the writer kept publishing
+        */
+        int read(MAX17332_Reading& reading, uint16_t max_retries = MAX17332_SAMPLER_MAX_RETRIES) const;
+
+        /**
+            @brief  Any task. Single read() attempt
+            @return 1 if OK; 0 if nothing was published yet or the writer was publishing
+        */
+        int tryRead(MAX17332_Reading& reading) const;
+
+        /**
+            @brief  Any task. Returns the number of published readings
+        */
+        uint32_t count() const;
+
+    private:
+        void publish(const MAX17332_Reading& reading);
+
+        static const size_t WORDS = (sizeof(MAX17332_Reading) + sizeof(MAX17332_SeqWord) - 1) / sizeof(MAX17332_SeqWord);
+
+        MAX17332* _gauge;
+        MAX17332_ReadPlan _plan;
+        uint32_t _period;
+        uint32_t _last;
+        uint32_t _count;                    ///< owning task only
+        MAX17332_SeqWord _sequence;         ///< odd while publishing, 0 before the first reading
+        MAX17332_SeqWord _words[WORDS];     ///< published MAX17332_Reading
+        uint8_t _requests;                  ///< bumped by request()
+        uint8_t _served;                    ///< _requests seen by the last service()
+
+};
+
+#endif
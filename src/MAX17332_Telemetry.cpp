@@ -0,0 +1,285 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Telemetry.h"
+
+static_assert(MAX17332_TELEMETRY_KEYFRAME >= 1 && MAX17332_TELEMETRY_KEYFRAME <= 255,
+              "MAX17332_TELEMETRY_KEYFRAME must fit the keyframe record count byte");
+
+#define MAX17332_TELEMETRY_KEY_FLAG     0x01        ///< LSB of the first varint of a record
+#define MAX17332_TELEMETRY_DT_LIMIT     (1L << 19)  ///< time step changes beyond this start a keyframe (keeps dt in 3 bytes)
+
+static const uint16_t MAX17332_telemetry_registers[] = {
+    MAX17332_VCELLREP_REG,
+    MAX17332_CURRREP_REG,
+    MAX17332_TEMP_REG,
+    MAX17332_REPSOC_REG
+};
+
+static inline uint16_t zigzag16(uint16_t delta) {
+    // Shift the unsigned bits: left-shifting a negative value is undefined
+    int16_t d = static_cast<int16_t>(delta);
+    return (uint16_t) ((uint16_t) (delta << 1) ^ (uint16_t) (d >> 15));
+}
+
+static inline uint16_t unzigzag16(uint32_t value) {
+    return (uint16_t) ((value >> 1) ^ (0 - (value & 1)));
+}
+
+static inline uint8_t encodeVarint(uint8_t* out, uint32_t value) {
+    uint8_t length = 0;
+
+    while (value >= 0x80) {
+        out[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[length++] = value;
+
+    return length;
+}
+
+static inline void sampleFields(const MAX17332_Sample& sample, uint16_t* fields) {
+    fields[0] = sample.vcell;
+    fields[1] = sample.current;
+    fields[2] = sample.temp;
+    fields[3] = sample.soc;
+}
+
+MAX17332_Telemetry::MAX17332_Telemetry(MAX17332& gauge, uint8_t* buffer, size_t size):
+    _gauge(&gauge),
+    _plan(MAX17332_telemetry_registers, MAX17332_TELEMETRY_FIELDS),
+    _buffer(buffer),
+    _size(size > 0xFFFF ? 0xFFFF : size),
+    _evictions(0)
+{
+    clear();
+}
+
+int MAX17332_Telemetry::record() {
+    uint16_t words[MAX17332_PLAN_MAX_REGS];
+    MAX17332_Sample sample;
+
+    if (_gauge->poll(_plan, words) != 1) {
+        return 0;
+    }
+
+    sample.timestamp = millis();
+    sample.vcell = _plan.value(words, MAX17332_VCELLREP_REG);
+    sample.current = _plan.value(words, MAX17332_CURRREP_REG);
+    sample.temp = _plan.value(words, MAX17332_TEMP_REG);
+    sample.soc = _plan.value(words, MAX17332_REPSOC_REG);
+
+    return append(sample);
+}
+
+int MAX17332_Telemetry::append(const MAX17332_Sample& sample) {
+    uint8_t record[MAX17332_TELEMETRY_RECORD_MAX];
+    uint8_t length = 0;
+    uint32_t dt = sample.timestamp - _last.timestamp;
+    int32_t ddt = (int32_t) (dt - _dt);
+    bool key = (_records == 0) || (_open_records >= MAX17332_TELEMETRY_KEYFRAME) ||
+               (ddt >= MAX17332_TELEMETRY_DT_LIMIT) || (ddt < -MAX17332_TELEMETRY_DT_LIMIT);
+
+    if (!key) {
+        uint16_t fields[MAX17332_TELEMETRY_FIELDS];
+        uint16_t last[MAX17332_TELEMETRY_FIELDS];
+
+        sampleFields(sample, fields);
+        sampleFields(_last, last);
+
+        length = encodeVarint(record, (((uint32_t) ddt << 1) ^ (uint32_t) (ddt >> 31)) << 1);
+        for (uint8_t i = 0; i < MAX17332_TELEMETRY_FIELDS; i++) {
+            length += encodeVarint(record + length, zigzag16(fields[i] - last[i]));
+        }
+
+        // A segment holds at most 1 / MAX17332_TELEMETRY_SEGMENTS of the buffer, so an eviction
+        // never drops the whole history
+        key = (_open_bytes + length > _size / MAX17332_TELEMETRY_SEGMENTS);
+
+        // Only closed segments can be evicted: otherwise restart with a keyframe
+        while (!key && _size - _used < length && _tail != _open) {
+            evict();
+        }
+        key = key || (_size - _used < length);
+    }
+
+    if (key) {
+        if (_size < MAX17332_TELEMETRY_KEYFRAME_SIZE) {
+            return -1;
+        }
+
+        if (_records > 0) {
+            // Close the open segment with its length
+            patch(_open + 1, _open_bytes & 0xFF);
+            patch(_open + 2, _open_bytes >> 8);
+        }
+
+        while (_size - _used < MAX17332_TELEMETRY_KEYFRAME_SIZE) {
+            evict();
+        }
+
+        _open = _head;
+        _open_records = 0;
+        _open_bytes = 0;
+        _dt = 0;
+
+        put(MAX17332_TELEMETRY_KEY_FLAG);
+        put(0);                         // segment length, patched when closed
+        put(0);
+        put(0);                         // record count, patched on every append
+        for (uint8_t i = 0; i < 4; i++) {
+            put((sample.timestamp >> (8 * i)) & 0xFF);
+        }
+
+        uint16_t fields[MAX17332_TELEMETRY_FIELDS];
+        sampleFields(sample, fields);
+        for (uint8_t i = 0; i < MAX17332_TELEMETRY_FIELDS; i++) {
+            put(fields[i] & 0xFF);
+            put(fields[i] >> 8);
+        }
+    } else {
+        for (uint8_t i = 0; i < length; i++) {
+            put(record[i]);
+        }
+        _dt = dt;
+    }
+
+    _open_records++;
+    patch(_open + 3, _open_records);
+    _records++;
+    _last = sample;
+
+    return 1;
+}
+
+void MAX17332_Telemetry::clear() {
+    _tail = 0;
+    _head = 0;
+    _used = 0;
+    _records = 0;
+    _open = 0;
+    _open_records = 0;
+    _open_bytes = 0;
+    _dt = 0;
+    memset(&_last, 0, sizeof(_last));
+}
+
+size_t MAX17332_Telemetry::records() const {
+    return _records;
+}
+
+size_t MAX17332_Telemetry::used() const {
+    return _used;
+}
+
+size_t MAX17332_Telemetry::capacity() const {
+    return _size;
+}
+
+uint32_t MAX17332_Telemetry::evictions() const {
+    return _evictions;
+}
+
+uint8_t MAX17332_Telemetry::at(size_t offset) const {
+    return _buffer[(_tail + offset) % _size];
+}
+
+void MAX17332_Telemetry::put(uint8_t value) {
+    _buffer[_head] = value;
+    _head = (_head + 1) % _size;
+    _used++;
+    _open_bytes++;
+}
+
+void MAX17332_Telemetry::patch(size_t position, uint8_t value) {
+    _buffer[position % _size] = value;
+}
+
+void MAX17332_Telemetry::evict() {
+    size_t length = at(1) | (at(2) << 8);
+
+    _records -= at(3);
+    _tail = (_tail + length) % _size;
+    _used -= length;
+    _evictions++;
+}
+
+MAX17332_TelemetryReader::MAX17332_TelemetryReader(const MAX17332_Telemetry& telemetry): _telemetry(&telemetry) {
+    rewind();
+}
+
+void MAX17332_TelemetryReader::rewind() {
+    _offset = 0;
+    _evictions = _telemetry->_evictions;
+    _dt = 0;
+    memset(&_last, 0, sizeof(_last));
+}
+
+int MAX17332_TelemetryReader::read(MAX17332_Sample& sample) {
+
+    if (_evictions != _telemetry->_evictions || _offset >= _telemetry->_used) {
+        return 0;
+    }
+
+    uint32_t first = varint();
+
+    if (first & MAX17332_TELEMETRY_KEY_FLAG) {
+        _offset += 3;                   // segment length and record count
+        _last.timestamp = 0;
+        for (uint8_t i = 0; i < 4; i++) {
+            _last.timestamp |= (uint32_t) byte() << (8 * i);
+        }
+        _last.vcell = word();
+        _last.current = word();
+        _last.temp = word();
+        _last.soc = word();
+        _dt = 0;
+    } else {
+        uint32_t zz = first >> 1;
+        _dt += (zz >> 1) ^ (0 - (zz & 1));
+        _last.timestamp += _dt;
+        _last.vcell += unzigzag16(varint());
+        _last.current += unzigzag16(varint());
+        _last.temp += unzigzag16(varint());
+        _last.soc += unzigzag16(varint());
+    }
+
+    sample = _last;
+
+    return 1;
+}
+
+uint8_t MAX17332_TelemetryReader::byte() {
+    return _telemetry->at(_offset++);
+}
+
+uint16_t MAX17332_TelemetryReader::word() {
+    // byte() advances the offset: sequence the reads, the operands of | are unordered
+    uint8_t lo = byte();
+    uint8_t hi = byte();
+
+    return lo | (hi << 8);
+}
+
+uint32_t MAX17332_TelemetryReader::varint() {
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+
+    do {
+        b = byte();
+        value |= (uint32_t) (b & 0x7F) << shift;
+        shift += 7;
+    } while ((b & 0x80) && shift < 35);
+
+    return value;
+}
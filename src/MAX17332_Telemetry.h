@@ -0,0 +1,154 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_TELEMETRY_H_
+#define  _MAX17332_TELEMETRY_H_
+
+#include "MAX17332.h"
+
+#define MAX17332_TELEMETRY_FIELDS           4       ///< VCELLREP, CURRREP, TEMP, REPSOC
+#define MAX17332_TELEMETRY_KEYFRAME         32      ///< records per segment (at most 255), a keyframe starts each segment
+#define MAX17332_TELEMETRY_SEGMENTS         4       ///< a segment is closed early once it would exceed this fraction of the buffer
+#define MAX17332_TELEMETRY_KEYFRAME_SIZE    16      ///< bytes: flag, segment length (2), record count, timestamp (4), raw words (8)
+#define MAX17332_TELEMETRY_RECORD_MAX       15      ///< bytes: dt varint (3) and one zigzag varint per field (3 each)
+
+/**
+ * Struct for storing a telemetry sample as raw register words. Decode with MAX17332_Reg
+ * (e.g. MAX17332_Reg::VCellRep::decodeInt(sample.vcell)) and current with MAX17332::currentMicroAmps()
+*/
+typedef struct
+{
+    uint32_t timestamp;     ///< millis()
+    uint16_t vcell;         ///< VCELLREP_REG
+    uint16_t current;       ///< CURRREP_REG, two's complement
+    uint16_t temp;          ///< TEMP_REG, two's complement
+    uint16_t soc;           ///< REPSOC_REG
+
+} MAX17332_Sample;
+
+class MAX17332_Telemetry;
+
+/**
+ * Streaming decoder over the records of a MAX17332_Telemetry, oldest first.
+ * Appending while reading may evict the segment being read: read() then returns 0
+*/
+class MAX17332_TelemetryReader {
+
+    public:
+        MAX17332_TelemetryReader(const MAX17332_Telemetry& telemetry);
+
+        /**
+            @brief  Restarts from the oldest record
+        */
+        void rewind();
+
+        /**
+            @brief  Decodes the next record
+            @return 1 if OK; 0 at the end of the log (or if the reader was invalidated by an eviction)
+        */
+        int read(MAX17332_Sample& sample);
+
+    private:
+        uint8_t byte();
+        uint16_t word();        ///< little endian
+        uint32_t varint();
+
+        const MAX17332_Telemetry* _telemetry;
+        size_t _offset;         ///< bytes from the log tail
+        uint32_t _evictions;    ///< telemetry evictions at rewind()
+        MAX17332_Sample _last;
+        uint32_t _dt;
+
+};
+
+/**
+ * Fixed-footprint telemetry log in a caller provided ring buffer. Each record stores the raw
+ * VCELLREP, CURRREP, TEMP and REPSOC words as zigzag varint deltas from the previous record,
+ * and the time step as a delta from the previous step: a steady 10 Hz log takes about 5
+ * bytes per record instead of 20 for a timestamp and four floats. Every
+ * MAX17332_TELEMETRY_KEYFRAME records, or earlier once a segment would exceed
+ * 1 / MAX17332_TELEMETRY_SEGMENTS of the buffer, a keyframe with absolute values starts a segment;
+ * when the buffer is full the oldest segment is evicted in O(1)
+*/
+class MAX17332_Telemetry {
+
+    public:
+        /**
+            @param  gauge MAX17332 to sample
+            @param  buffer caller owned storage (at most 65535 bytes)
+            @param  size buffer size in bytes. A few segments long for useful history
+        */
+        MAX17332_Telemetry(MAX17332& gauge, uint8_t* buffer, size_t size);
+
+        /**
+            @brief  Reads the telemetry registers and appends a sample
+            @return 1 if OK; 0 on transmission error; -1 if the buffer cannot hold a keyframe
+        */
+        int record();
+
+        /**
+            @brief  Appends a sample. Timestamps must not decrease
+            @return 1 if OK; -1 if the buffer cannot hold a keyframe
+        */
+        int append(const MAX17332_Sample& sample);
+
+        /**
+            @brief  Drops all records
+        */
+        void clear();
+
+        /**
+            @brief  Returns the number of stored records
+        */
+        size_t records() const;
+
+        /**
+            @brief  Returns the number of used bytes
+        */
+        size_t used() const;
+
+        /**
+            @brief  Returns the buffer size
+        */
+        size_t capacity() const;
+
+        /**
+            @brief  Returns the number of segments evicted since construction
+        */
+        uint32_t evictions() const;
+
+    private:
+        friend class MAX17332_TelemetryReader;
+
+        uint8_t at(size_t offset) const;
+        void put(uint8_t value);
+        void patch(size_t position, uint8_t value);
+        void evict();
+
+        MAX17332* _gauge;
+        MAX17332_ReadPlan _plan;
+        uint8_t* _buffer;
+        size_t _size;
+        size_t _tail;           ///< position of the oldest keyframe
+        size_t _head;           ///< next write position
+        size_t _used;
+        size_t _records;
+        size_t _open;           ///< position of the keyframe of the segment being written
+        uint8_t _open_records;
+        size_t _open_bytes;
+        uint32_t _evictions;
+        MAX17332_Sample _last;
+        uint32_t _dt;
+
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_TRANSPORT_H_
+#define  _MAX17332_TRANSPORT_H_
+
+/**
+ * The register access layer talks to the bus through MAX17332_Transport, chosen at compile time
+ * (no virtual dispatch). A transport provides:
+ *
+ *   typedef ... Bus;                                           // what MAX17332(bus) is constructed from
+ *   Transport(Bus& bus);
+ *   void begin(); void end();
+ *   int read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+ *                          // register write then repeated start read: 1 if OK; -1 on NACK; 0 on short read
+ *   int write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length);
+ *                          // register then data in one transaction: 1 if OK; 0 on transmission error
+ *   void beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+ *   int pollRead();        // split-phase read(): MAX17332_TRANSPORT_PENDING until data is filled, then read()'s result.
+ *                          // Transports without async transfers complete the read in beginRead()
+ *   Bus* bus();
+ *
+ * Define MAX17332_TRANSPORT_I2CDEV=1 (e.g. as a build flag, Linux only) to use /dev/i2c-N
+ * instead of TwoWire.
+ *
+ * Define MAX17332_TRANSPORT_CLASS to plug in any other class with this interface, e.g. a DMA or
+ * interrupt driven driver whose pollRead() really returns MAX17332_TRANSPORT_PENDING, and
+ * MAX17332_TRANSPORT_HEADER to the header declaring it:
+ *
+ *   -DMAX17332_TRANSPORT_CLASS=MyDmaTransport -DMAX17332_TRANSPORT_HEADER='"MyDmaTransport.h"'
+ *
+ * These are build flags, not sketch defines: every library file must see the same transport.
+*/
+#define MAX17332_TRANSPORT_PENDING  2
+
+#ifndef MAX17332_TRANSPORT_I2CDEV
+#define MAX17332_TRANSPORT_I2CDEV   0
+#endif
+
+#if defined(MAX17332_TRANSPORT_CLASS)
+#if defined(MAX17332_TRANSPORT_HEADER)
+#include MAX17332_TRANSPORT_HEADER
+#endif
+typedef MAX17332_TRANSPORT_CLASS MAX17332_Transport;
+#elif MAX17332_TRANSPORT_I2CDEV
+#include "MAX17332_I2cDevTransport.h"
+typedef MAX17332_I2cDevTransport MAX17332_Transport;
+#else
+#include "MAX17332_WireTransport.h"
+typedef MAX17332_WireTransport MAX17332_Transport;
+#endif
+
+#endif
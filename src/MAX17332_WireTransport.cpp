@@ -0,0 +1,69 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_Transport.h"
+
+#if !defined(MAX17332_TRANSPORT_CLASS) && !MAX17332_TRANSPORT_I2CDEV
+
+MAX17332_WireTransport::MAX17332_WireTransport(TwoWire& wire): _wire(&wire), _read_result(0) {}
+
+void MAX17332_WireTransport::begin() {
+    _wire->begin();
+}
+
+void MAX17332_WireTransport::end() {
+    _wire->end();
+}
+
+int MAX17332_WireTransport::read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    _wire->beginTransmission(i2c_address);
+    _wire->write(reg);
+
+    if (_wire->endTransmission(false) != 0) {
+        return -1;
+    }
+
+    if (_wire->requestFrom(i2c_address, length) != length) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        *data++ = _wire->read();
+    }
+
+    return 1;
+}
+
+int MAX17332_WireTransport::write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length) {
+    _wire->beginTransmission(i2c_address);
+    _wire->write(reg);
+
+    for (size_t i = 0; i < length; i++) {
+        _wire->write(data[i]);
+    }
+
+    return _wire->endTransmission() == 0 ? 1 : 0;
+}
+
+void MAX17332_WireTransport::beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length) {
+    _read_result = read(i2c_address, reg, data, length);
+}
+
+int MAX17332_WireTransport::pollRead() {
+    return _read_result;
+}
+
+TwoWire* MAX17332_WireTransport::bus() {
+    return _wire;
+}
+
+#endif
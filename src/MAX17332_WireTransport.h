@@ -0,0 +1,63 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_WIRE_TRANSPORT_H_
+#define  _MAX17332_WIRE_TRANSPORT_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * Arduino TwoWire transport (see MAX17332_Transport.h)
+*/
+class MAX17332_WireTransport {
+
+    public:
+        typedef TwoWire Bus;
+
+        MAX17332_WireTransport(TwoWire& wire);
+
+        void begin();
+        void end();
+
+        /**
+            @brief  Writes reg, then reads length bytes after a repeated start
+            @return 1 if OK; -1 on NACK; 0 if bytes received are less than length
+        */
+        int read(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+
+        /**
+            @brief  Writes reg followed by length bytes of data in one transaction
+            @return 1 if OK; 0 on transmission error
+        */
+        int write(uint8_t i2c_address, uint8_t reg, const uint8_t* data, size_t length);
+
+        /**
+            @brief  Starts a split-phase read. Blocking fallback: the read completes here
+        */
+        void beginRead(uint8_t i2c_address, uint8_t reg, uint8_t* data, size_t length);
+
+        /**
+            @brief  Returns the result of the read started by beginRead()
+            @return MAX17332_TRANSPORT_PENDING while in flight; then as read()
+        */
+        int pollRead();
+
+        TwoWire* bus();
+
+    private:
+        TwoWire* _wire;
+        int _read_result;       ///< result of the last beginRead()
+
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#include "MAX17332_WriteSession.h"
+
+MAX17332_WriteSession::MAX17332_WriteSession(MAX17332& gauge):
+    _gauge(&gauge), _count(0), _reset(false), _rsense(false), _ok(true), _transactions(0)
+{
+    _ok = (_gauge->freeMem() == 1);
+}
+
+MAX17332_WriteSession::~MAX17332_WriteSession() {
+    if (_count > 0 || _reset) {
+        commit();
+    }
+
+    _gauge->protectMem();
+}
+
+int MAX17332_WriteSession::write(uint16_t address, uint16_t value) {
+
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_addresses[i] == address) {
+            _values[i] = value;
+            return 1;
+        }
+    }
+
+    int ret = 1;
+    if (_count >= MAX17332_SESSION_MAX_WORDS) {
+        ret = flush();
+    }
+
+    _addresses[_count] = address;
+    _values[_count] = value;
+    _count++;
+
+    if (address >= NVM_START_ADDRESS && !MAX17332::isUserMem(address)) {
+        _reset = true;
+    }
+    _rsense |= (address == MAX17332_RSENSE_REG);
+
+    return ret;
+}
+
+int MAX17332_WriteSession::commit() {
+    int ret = flush();
+
+    if (ret == 1 && _reset) {
+        ret = _gauge->resetFirmware();
+    }
+
+    if (_rsense) {
+        _gauge->calibrate();
+    }
+
+    // Written status words are stale in the cache
+    _gauge->_status_valid = 0;
+
+    _reset = false;
+    _rsense = false;
+    _ok = true;
+
+    return ret;
+}
+
+uint16_t MAX17332_WriteSession::transactions() {
+    return _transactions;
+}
+
+int MAX17332_WriteSession::flush() {
+    uint8_t data[NVM_DIFF_MAX_RUN_WORDS * 2];
+    uint8_t i = 0;
+
+    while (i < _count) {
+        uint16_t start = _addresses[i];
+        uint8_t words = 0;
+
+        // Extend the burst while the queue holds the next register of the same bank
+        while (i + words < _count && words < NVM_DIFF_MAX_RUN_WORDS && _addresses[i + words] == start + words &&
+               _gauge->get_i2c_address(start + words) == _gauge->get_i2c_address(start)) {
+            data[words * 2] = _values[i + words] & 0xFF;
+            data[words * 2 + 1] = _values[i + words] >> 8;
+            words++;
+        }
+
+        int ret = (words == 1) ? _gauge->writeRegister(start, _values[i]) : _gauge->writeRegisters(start, data, words * 2);
+        _transactions++;
+        if (ret != 1) {
+            _ok = false;
+        }
+
+        i += words;
+    }
+
+    _count = 0;
+
+    return _ok ? 1 : 0;
+}
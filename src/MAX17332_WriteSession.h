@@ -0,0 +1,77 @@
+/*
+
+	Arduino MAX17332 library
+
+	Copyright (c) 2023 Arduino SA
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+*/
+
+#ifndef  _MAX17332_WRITE_SESSION_H_
+#define  _MAX17332_WRITE_SESSION_H_
+
+#include "MAX17332.h"
+
+#define MAX17332_SESSION_MAX_WORDS  16          ///< queued words before an automatic flush
+
+/**
+ * Scoped write access to the MAX17332. Memory is unlocked once on construction and relocked on
+ * destruction; queued words are written as bursts of consecutive registers and shadow RAM
+ * changes that affect the fuel gauge model share one firmware reset at commit(), e.g.
+ *
+ *   {
+ *       MAX17332_WriteSession session(BMS);
+ *       session.write(MAX17332_RSENSE_REG, 5000);
+ *       session.write(MAX17332_USERMEM_1C6, 0xAFBF);
+ *       ret = session.commit();
+ *   }
+*/
+class MAX17332_WriteSession {
+
+    public:
+        MAX17332_WriteSession(MAX17332& gauge);
+
+        /**
+            @brief  Commits pending words (result lost, call commit() to check it) and restores write protection
+        */
+        ~MAX17332_WriteSession();
+
+        /**
+            @brief  Queues a register write. Words are written in queue order; a word queued again keeps its place.
+                    Consecutive registers of the same bank queued in a row share one burst
+            @param  address 9-bit address
+            @param  value the data word
+            @return 1 if OK; 0 if flushing a full queue failed
+        */
+        int write(uint16_t address, uint16_t value);
+
+        /**
+            @brief  Writes the queued words, then runs one firmware reset if any shadow RAM word affecting
+                    the model was written since the last commit()
+            @return 1 if OK; 0 on transmission error; MAX17332_TIMEOUT if the firmware reset did not complete
+        */
+        int commit();
+
+        /**
+            @brief  Returns the number of register write transactions issued so far
+        */
+        uint16_t transactions();
+
+    private:
+        int flush();
+
+        MAX17332* _gauge;
+        uint16_t _addresses[MAX17332_SESSION_MAX_WORDS];
+        uint16_t _values[MAX17332_SESSION_MAX_WORDS];
+        uint8_t _count;
+        bool _reset;            ///< a model word was written since the last commit
+        bool _rsense;           ///< nRSense was written since the last commit
+        bool _ok;               ///< no write failed since the last commit
+        uint16_t _transactions;
+
+};
+
+#endif